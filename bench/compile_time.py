@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""
+C compile time benchmark for transpiled output.
+
+Generates a synthetic corpus of .d modules, transpiles each one and compiles the result with
+every available compiler using -ftime-report. Per generated file it records the compile wall
+time, the compiler's own reported total, the generated size and the preprocessed size, so
+changes to replace_structs or generate_transformed_method can be judged on build time.
+"""
+import argparse
+import json
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+TRANSPILER = ROOT / "main.py"
+OUTPUT_FILE = ROOT / "bench_output_compile_time.txt"
+
+# gcc ends its report with " TOTAL : 0.12 0.01 0.14 ...", clang with "Total" rows per timer group
+GCC_TOTAL_PATTERN = r"^\s*TOTAL\s*:\s*([\d.]+)\s+([\d.]+)\s+([\d.]+)"
+CLANG_TOTAL_PATTERN = r"^\s*([\d.]+)\s+\(\s*[\d.]+%\)\s+.*\bTotal\b"
+
+
+def generate_module(index, structs, methods, globals_per_struct):
+    """Builds one synthetic .d module with structs, methods, globals and a main exercising them."""
+    lines = ["#include <stdio.h>", "#include <stdlib.h>", ""]
+    calls = []
+    for s in range(structs):
+        name = f"Module{index}Type{s}"
+        lines.append(f"struct {name}{{")
+        lines.append("    int value;")
+        lines.append("    long total;")
+        for g in range(globals_per_struct):
+            lines.append(f"    long @counter{g};")
+        for m in range(methods):
+            lines.append(f"    int @method{m}({name} *self, int amount){{")
+            lines.append(f"        self->total += amount * {m + 1};")
+            if globals_per_struct:
+                lines.append(f"        {name}@counter{m % globals_per_struct}++;")
+            lines.append("        if(self->total < 0) exit(1);")
+            lines.append("        return self->value + amount;")
+            lines.append("    };")
+        lines.append("};")
+        lines.append("")
+        calls.append(name)
+
+    lines.append("int main(){")
+    for s, name in enumerate(calls):
+        lines.append(f"    {name} object{s};")
+        lines.append(f"    object{s}.value = {s};")
+        lines.append(f"    object{s}.total = 0;")
+        for m in range(methods):
+            lines.append(f"    object{s}@method{m}({m});")
+    lines.append("    return 0;")
+    lines.append("}")
+    return "\n".join(lines) + "\n"
+
+
+def reported_total(compiler, report):
+    """Extracts the total time in seconds from a -ftime-report dump, or None when it is not found."""
+    pattern = CLANG_TOTAL_PATTERN if "clang" in compiler else GCC_TOTAL_PATTERN
+    totals = [float(match.group(1)) for match in re.finditer(pattern, report, re.MULTILINE)]
+    if not totals:
+        return None
+    return max(totals) if "clang" in compiler else totals[-1]
+
+
+def compile_once(compiler, level, source, obj):
+    """Compiles a file once, returning the wall time and the -ftime-report output."""
+    start = time.perf_counter()
+    result = subprocess.run([compiler, level, "-ftime-report", "-c", str(source), "-o", str(obj)],
+                            capture_output=True, text=True)
+    elapsed = time.perf_counter() - start
+    if result.returncode != 0:
+        raise RuntimeError(f"{compiler} failed on {source}:\n{result.stderr}")
+    return elapsed, result.stderr
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Measure C compile time of transpiled output.")
+    parser.add_argument("--compilers", default="gcc,clang", help="Comma separated compilers, missing ones are skipped")
+    parser.add_argument("--level", default="-O2", help="Optimization level")
+    parser.add_argument("--modules", type=int, default=4, help="Number of generated .d modules")
+    parser.add_argument("--structs", type=int, default=20, help="Structs per module")
+    parser.add_argument("--methods", type=int, default=10, help="Methods per struct")
+    parser.add_argument("--globals", type=int, default=4, help="Namespace globals per struct")
+    parser.add_argument("--repeat", type=int, default=3, help="Compiles per file, the fastest is kept")
+    parser.add_argument("--json", help="Write the results to this JSON file")
+    parser.add_argument("--baseline", help="JSON results of an earlier run to compare against")
+    args = parser.parse_args()
+
+    compilers = [compiler for compiler in args.compilers.split(',') if shutil.which(compiler)]
+    if not compilers:
+        print("No compiler found", file=sys.stderr)
+        sys.exit(1)
+
+    results = []
+    with tempfile.TemporaryDirectory() as workdir:
+        workdir = Path(workdir)
+        for index in range(args.modules):
+            source = workdir / f"module{index}.d"
+            source.write_text(generate_module(index, args.structs, args.methods, args.globals))
+            generated = workdir / f"module{index}.c"
+            start = time.perf_counter()
+            subprocess.run([sys.executable, str(TRANSPILER), str(source), "-o", str(generated)],
+                           check=True, capture_output=True)
+            transpile_time = time.perf_counter() - start
+
+            for compiler in compilers:
+                preprocessed = subprocess.run([compiler, "-E", str(generated)], check=True,
+                                              capture_output=True, text=True).stdout
+                best_wall = None
+                report = ""
+                for _ in range(args.repeat):
+                    wall, report_text = compile_once(compiler, args.level, generated, workdir / "out.o")
+                    if best_wall is None or wall < best_wall:
+                        best_wall, report = wall, report_text
+                results.append({
+                    "file": generated.name,
+                    "compiler": compiler,
+                    "level": args.level,
+                    "transpile_s": round(transpile_time, 4),
+                    "compile_wall_s": round(best_wall, 4),
+                    "compile_reported_s": reported_total(compiler, report),
+                    "generated_bytes": generated.stat().st_size,
+                    "preprocessed_bytes": len(preprocessed),
+                    "preprocessed_lines": preprocessed.count("\n"),
+                })
+
+    baseline = {}
+    if args.baseline:
+        for entry in json.loads(Path(args.baseline).read_text()):
+            baseline[(entry["file"], entry["compiler"], entry["level"])] = entry
+
+    lines = [f"{'file':<14} {'compiler':<8} {'wall s':>8} {'report s':>9} {'gen KB':>8} {'pp KB':>8} {'pp lines':>9} {'vs base':>8}"]
+    for entry in results:
+        previous = baseline.get((entry["file"], entry["compiler"], entry["level"]))
+        delta = f"{entry['compile_wall_s'] / previous['compile_wall_s']:.3f}x" if previous else "-"
+        reported = f"{entry['compile_reported_s']:.3f}" if entry["compile_reported_s"] is not None else "-"
+        lines.append(f"{entry['file']:<14} {entry['compiler']:<8} {entry['compile_wall_s']:>8.3f} {reported:>9} "
+                     f"{entry['generated_bytes'] / 1024:>8.1f} {entry['preprocessed_bytes'] / 1024:>8.1f} "
+                     f"{entry['preprocessed_lines']:>9} {delta:>8}")
+    report = "\n".join(lines) + "\n"
+    print(report, end="")
+    OUTPUT_FILE.write_text(report)
+    if args.json:
+        Path(args.json).write_text(json.dumps(results, indent=2) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+"""
+Zero cost check for the namespace sugar.
+
+Every bench/zero_cost/<name>.d program has a hand written bench/zero_cost/<name>_ref.c twin.
+Both are compiled at each optimization level, run with the same arguments and compared on
+runtime and on the number of instructions in the generated assembly. The run fails when the
+transpiled program is slower or larger than its twin beyond the thresholds.
+"""
+import argparse
+import re
+import subprocess
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+PROGRAMS = Path(__file__).resolve().parent / "zero_cost"
+TRANSPILER = ROOT / "main.py"
+OUTPUT_FILE = ROOT / "bench_output_zero_cost.txt"
+
+# Assembly lines that are not instructions: directives, labels and comments
+NON_INSTRUCTION_PATTERN = r"^\s*(?:\.|[\w.$]+:|#|$)"
+
+
+def run(command, **kwargs):
+    """Runs a command, raising with its output when it fails."""
+    result = subprocess.run(command, capture_output=True, text=True, **kwargs)
+    if result.returncode != 0:
+        raise RuntimeError(f"{' '.join(map(str, command))} failed:\n{result.stdout}{result.stderr}")
+    return result.stdout
+
+
+def instruction_count(cc, source, level):
+    """Counts the instructions the compiler emits for a source file."""
+    assembly = run([cc, level, "-S", "-o", "-", str(source)])
+    return sum(1 for line in assembly.splitlines() if not re.match(NON_INSTRUCTION_PATTERN, line))
+
+
+def best_runtime(binary, args, repeat):
+    """Returns the fastest wall time over several runs together with the program output."""
+    best = None
+    output = None
+    for _ in range(repeat):
+        start = time.perf_counter()
+        output = run([str(binary)] + args)
+        elapsed = time.perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best, output
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare transpiled programs against hand written C.")
+    parser.add_argument("--cc", default="cc", help="C compiler to use")
+    parser.add_argument("--levels", default="-O2,-O3", help="Comma separated optimization levels")
+    parser.add_argument("--rounds", default="100000000", help="Loop count passed to every program")
+    parser.add_argument("--repeat", type=int, default=5, help="Runs per binary, the fastest is kept")
+    parser.add_argument("--threshold", type=float, default=0.05, help="Allowed runtime regression as a fraction")
+    parser.add_argument("--size_threshold", type=float, default=0.10, help="Allowed instruction count regression as a fraction")
+    parser.add_argument("--filter", default="", help="Only run programs whose name contains this text")
+    args = parser.parse_args()
+
+    rows = []
+    failures = []
+    with tempfile.TemporaryDirectory() as workdir:
+        workdir = Path(workdir)
+        for source in sorted(PROGRAMS.glob("*.d")):
+            name = source.stem
+            if args.filter not in name:
+                continue
+            reference = PROGRAMS / f"{name}_ref.c"
+            transpiled = workdir / f"{name}.c"
+            run([sys.executable, str(TRANSPILER), str(source), "-o", str(transpiled)])
+
+            for level in args.levels.split(','):
+                times = {}
+                sizes = {}
+                outputs = {}
+                for variant, c_file in (("transpiled", transpiled), ("reference", reference)):
+                    binary = workdir / f"{name}_{variant}{level}"
+                    run([args.cc, level, "-o", str(binary), str(c_file)])
+                    times[variant], outputs[variant] = best_runtime(binary, [args.rounds], args.repeat)
+                    sizes[variant] = instruction_count(args.cc, c_file, level)
+
+                time_ratio = times["transpiled"] / times["reference"]
+                size_ratio = sizes["transpiled"] / sizes["reference"]
+                rows.append((name, level, times["transpiled"], times["reference"], time_ratio,
+                             sizes["transpiled"], sizes["reference"], size_ratio))
+                if outputs["transpiled"] != outputs["reference"]:
+                    failures.append(f"{name} {level}: output differs from the reference")
+                if time_ratio > 1 + args.threshold:
+                    failures.append(f"{name} {level}: runtime {time_ratio:.3f}x of the reference")
+                if size_ratio > 1 + args.size_threshold:
+                    failures.append(f"{name} {level}: {sizes['transpiled']} instructions vs {sizes['reference']}")
+
+    lines = [f"{'program':<20} {'level':<6} {'time':>10} {'ref time':>10} {'ratio':>7} {'insns':>7} {'ref insns':>10} {'ratio':>7}"]
+    for name, level, t, ref_t, t_ratio, size, ref_size, size_ratio in rows:
+        lines.append(f"{name:<20} {level:<6} {t:>10.4f} {ref_t:>10.4f} {t_ratio:>7.3f} {size:>7} {ref_size:>10} {size_ratio:>7.3f}")
+    lines.extend(f"FAIL {failure}" for failure in failures)
+    report = "\n".join(lines) + "\n"
+    print(report, end="")
+    OUTPUT_FILE.write_text(report)
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,24 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct Lcg_globals {
+    unsigned long increment;
+    unsigned long draws;
+} Lcg_globals;
+Lcg_globals lcg_globals;
+
+unsigned long Lcg_next(unsigned long state) {
+    lcg_globals.draws++;
+    return state * 6364136223846793005ul + lcg_globals.increment;
+}
+
+int main(int argc, char **argv) {
+    long rounds = argc > 1 ? atol(argv[1]) : 100000000;
+    unsigned long state = 1;
+    lcg_globals.increment = 1442695040888963407ul + argc;
+    for (long i = 0; i < rounds; i++) {
+        state = Lcg_next(state);
+    }
+    printf("%lu %lu\n", state, lcg_globals.draws);
+    return 0;
+}
@@ -0,0 +1,22 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+unsigned long Step_twice(unsigned long x) {
+    return x * 2 + 1;
+}
+
+unsigned long Step_rotate(unsigned long x) {
+    return (x << 13) | (x >> 51);
+}
+
+int main(int argc, char **argv) {
+    long rounds = argc > 1 ? atol(argv[1]) : 100000000;
+    unsigned long (*first)(unsigned long) = argc > 2 ? &Step_rotate : &Step_twice;
+    unsigned long (*second)(unsigned long) = argc > 2 ? &Step_twice : &Step_rotate;
+    unsigned long x = 7;
+    for (long i = 0; i < rounds; i++) {
+        x = first(x) ^ second(i);
+    }
+    printf("%lu\n", x);
+    return 0;
+}
@@ -0,0 +1,30 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct Accumulator {
+    unsigned long total;
+    unsigned long count;
+} Accumulator;
+
+void Accumulator_add(Accumulator *self, unsigned long value) {
+    self->total += value ^ (self->total >> 7);
+    self->count++;
+}
+
+unsigned long Accumulator_mean(Accumulator *self) {
+    return self->count ? self->total / self->count : 0;
+}
+
+int main(int argc, char **argv) {
+    long rounds = argc > 1 ? atol(argv[1]) : 100000000;
+    Accumulator by_value;
+    Accumulator *by_pointer = &by_value;
+    by_value.total = 0;
+    by_value.count = 0;
+    for (long i = 0; i < rounds; i++) {
+        Accumulator_add(&by_value, i);
+        Accumulator_add(by_pointer, i * 3);
+    }
+    printf("%lu\n", Accumulator_mean(by_pointer));
+    return 0;
+}
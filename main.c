@@ -1,3 +1,13 @@
+typedef struct Type3_globals_s Type3_globals_t;
+int Type3_f1();
+typedef struct OtherType_s OtherType_t;
+int OtherType_increment(int value);
+typedef struct MyType_s MyType_t;
+typedef struct MyType_globals_s MyType_globals_t;
+int MyType_add(MyType_t *self, int a);
+int MyType_increment(int value);
+MyType_t *MyType_get(MyType_t *self);
+int MyType_global_increment(int value);
 #include <stdio.h>
 
 // int globalVar = 42;
@@ -6,10 +16,8 @@
 // const unsigned int globalArray[10] = {0};
 // double *globalPointer;
 
-typedef struct Type3_globals_s Type3_globals_t;
 struct Type3_globals_s {
-    
-    int g1;
+     int g1;
 };
 Type3_globals_t Type3_globals;
 
@@ -18,10 +26,8 @@ int Type3_f1() {
     return 1;
 }
 
-
-typedef struct OtherType_s OtherType_t;
 struct OtherType_s {
-    int x;
+     int x;
 };
 
 
@@ -31,25 +37,22 @@ int OtherType_increment(int value) {
 
 
 
-
-typedef struct MyType_s MyType_t;
 struct MyType_s {
-    int ***x;
-    MyType_t *ref;
+     int ***x;
+     MyType_t *ref;
 };
 
-typedef struct MyType_globals_s MyType_globals_t;
 struct MyType_globals_s {
-    // this is a global comment!
-    unsigned int y;
-    int ****x;
+// this is a global comment!
+    unsigned  int y;
+     int ****x;
 };
 MyType_globals_t MyType_globals;
 
 
 int MyType_add(MyType_t *self, int a) {
     self->x += a;
-        return self->x;
+return self->x;
 }
 
 // this is a test comment
@@ -60,7 +63,7 @@ int MyType_increment(int value) {
 
 
 
-MyType_t *MyType_get(MyType_t *self, ) {
+MyType_t *MyType_get(MyType_t *self) {
     return self;
 }
 
@@ -70,7 +73,6 @@ int MyType_global_increment(int value) {
 }
 
 
-
 void myFunction() {
     int localVar = 10;
     if (localVar > 5) {
@@ -92,6 +94,7 @@ void myFunction() {
     //MyType_add(b, (MyType_globals.y)->a.b);
     MyType_add(b, (MyType_globals.y));
     MyType_add(b,20);
+    int d = (MyType_t**) 2000;
 }
 
 int add(int d, int b) {
@@ -108,7 +111,7 @@ int main(){
 }
 
 ///////////////////////////////////////
-// main.d source pre transform
+// main.c autogenerated from main.d: 
 // #include <stdio.h>
 // 
 // // int globalVar = 42;
@@ -183,6 +186,7 @@ int main(){
 //     //b@add(MyType@y->a.b);
 //     b@add(MyType@y);
 //     MyType@add(b,20);
+//     int d = (MyType **) 2000;
 // }
 // 
 // int add(int d, int b) {
@@ -1,12 +1,931 @@
 import re
 import pprint
+import struct
 import sys
-from dataclasses import dataclass, field
-from typing import List, Dict, Optional, Tuple
+from dataclasses import dataclass, field, replace
+from typing import List, Dict, Optional, Set, Tuple
 import logging
 import argparse
+import fnmatch
 
 logger = logging.getLogger(__name__)
+
+INSTRUMENT_MODES = ["calls", "latency", "trace", "perf"]
+DEAD_CODE_MODES = ["keep", "drop", "mark"]
+VISIBILITY_MODES = ["default", "hidden", "static"]
+
+# Attribute arguments may nest parentheses three deep, as in @simd(uniform(scale), linear(i:1))
+ATTRIBUTE_ARGUMENTS = r"(?:[^()\r\n]|\((?:[^()\r\n]|\([^()\r\n]*\))*\))*"
+ATTRIBUTE_PATTERN = rf"@(\w+)(?:\(({ATTRIBUTE_ARGUMENTS})\))?"
+
+# Sizes of the arithmetic C types on an LP64 target, which are also their alignments
+C_TYPE_SIZES = {
+    "char": 1, "signed char": 1, "unsigned char": 1, "_Bool": 1, "bool": 1, "int8_t": 1, "uint8_t": 1,
+    "short": 2, "unsigned short": 2, "int16_t": 2, "uint16_t": 2,
+    "int": 4, "unsigned int": 4, "unsigned": 4, "int32_t": 4, "uint32_t": 4, "float": 4,
+    "long": 8, "unsigned long": 8, "long long": 8, "unsigned long long": 8, "int64_t": 8, "uint64_t": 8,
+    "size_t": 8, "ssize_t": 8, "ptrdiff_t": 8, "intptr_t": 8, "uintptr_t": 8, "double": 8,
+}
+
+# Benchmark runner appended after the generated ns_benchmarks table by --bench
+BENCH_RUNNER = r"""static uint64_t ns_bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+static uint64_t ns_bench_batch(void (*run)(void), uint64_t iterations) {
+    uint64_t start = ns_bench_now();
+    for (uint64_t i = 0; i < iterations; i++) run();
+    return ns_bench_now() - start;
+}
+static int ns_bench_compare(const void *a, const void *b) {
+    double left = *(const double *)a;
+    double right = *(const double *)b;
+    return (left > right) - (left < right);
+}
+static double ns_bench_percentile(const double *sorted, int count, double percentile) {
+    int index = (int)(percentile / 100.0 * count + 0.999999) - 1;
+    return sorted[index < 0 ? 0 : (index >= count ? count - 1 : index)];
+}
+static int ns_bench_pin(int cpu) {
+#if defined(__linux__)
+    unsigned long mask[16] = {0};
+    if (cpu < 0 || cpu >= (int)(sizeof mask * 8)) return -1;
+    mask[cpu / (8 * sizeof mask[0])] |= 1ul << (cpu % (8 * sizeof mask[0]));
+    return (int)syscall(SYS_sched_setaffinity, 0, sizeof mask, mask);
+#else
+    (void)cpu;
+    return -1;
+#endif
+}
+// Usage: [--filter=text] [--samples=N] [--min-time=ms] [--warmup=ms] [--pin=cpu] [--json]
+static int ns_bench_main(int argc, char **argv) {
+    const char *filter = NULL;
+    int samples = 31;
+    double min_time_ms = 5;
+    double warmup_ms = 100;
+    int json = 0;
+    for (int arg = 1; arg < argc; arg++) {
+        if (!strncmp(argv[arg], "--filter=", 9)) filter = argv[arg] + 9;
+        else if (!strncmp(argv[arg], "--samples=", 10)) samples = atoi(argv[arg] + 10);
+        else if (!strncmp(argv[arg], "--min-time=", 11)) min_time_ms = atof(argv[arg] + 11);
+        else if (!strncmp(argv[arg], "--warmup=", 9)) warmup_ms = atof(argv[arg] + 9);
+        else if (!strncmp(argv[arg], "--pin=", 6)) {
+            if (ns_bench_pin(atoi(argv[arg] + 6)) != 0) fprintf(stderr, "could not pin to cpu %s\n", argv[arg] + 6);
+        }
+        else if (!strcmp(argv[arg], "--json")) json = 1;
+        else {
+            fprintf(stderr, "usage: %s [--filter=text] [--samples=N] [--min-time=ms] [--warmup=ms] [--pin=cpu] [--json]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (samples < 1) samples = 1;
+    double *times = malloc(sizeof(double) * (size_t)samples);
+    if (!times) return 1;
+    const char *separator = "";
+    if (json) printf("{\"benchmarks\":[");
+    else printf("%-32s %12s %12s %12s %12s %12s\n", "benchmark", "iterations", "min ns", "median ns", "p90 ns", "p99 ns");
+    for (size_t index = 0; index < NS_BENCH_COUNT; index++) {
+        const ns_benchmark *benchmark = &ns_benchmarks[index];
+        if (filter && !strstr(benchmark->name, filter)) continue;
+        // Warm up first so the batch size is calibrated against steady state timings
+        uint64_t warmup_end = ns_bench_now() + (uint64_t)(warmup_ms * 1e6);
+        while (ns_bench_now() < warmup_end) ns_bench_batch(benchmark->run, 1);
+        // Then double the batch until one batch fills the minimum sample time
+        uint64_t iterations = 1;
+        uint64_t min_time_ns = (uint64_t)(min_time_ms * 1e6);
+        while (ns_bench_batch(benchmark->run, iterations) < min_time_ns && iterations < (1ull << 40)) iterations *= 2;
+        for (int sample = 0; sample < samples; sample++)
+            times[sample] = (double)ns_bench_batch(benchmark->run, iterations) / (double)iterations;
+        qsort(times, (size_t)samples, sizeof(double), ns_bench_compare);
+        double median = ns_bench_percentile(times, samples, 50);
+        double p90 = ns_bench_percentile(times, samples, 90);
+        double p99 = ns_bench_percentile(times, samples, 99);
+        if (json) {
+            printf("%s\n{\"name\":\"%s\",\"iterations\":%llu,\"samples\":%d,\"min_ns\":%.3f,\"median_ns\":%.3f,\"p90_ns\":%.3f,\"p99_ns\":%.3f,\"max_ns\":%.3f}",
+                   separator, benchmark->name, (unsigned long long)iterations, samples, times[0], median, p90, p99, times[samples - 1]);
+            separator = ",";
+        } else {
+            printf("%-32s %12llu %12.3f %12.3f %12.3f %12.3f\n", benchmark->name, (unsigned long long)iterations, times[0], median, p90, p99);
+        }
+    }
+    if (json) printf("\n]}\n");
+    free(times);
+    return 0;
+}
+int main(int argc, char **argv) {
+    return ns_bench_main(argc, argv);
+}
+"""
+
+# C snippets emitted once at the top of the generated file when a feature needs them
+SUPPORT_CODE = {
+    "stddef": "#include <stddef.h>\n",
+    "simd_loop": (
+        "#if defined(_OPENMP)\n"
+        "#define NS_SIMD_LOOP _Pragma(\"omp simd\")\n"
+        "#elif defined(__clang__)\n"
+        "#define NS_SIMD_LOOP _Pragma(\"clang loop vectorize(assume_safety)\")\n"
+        "#elif defined(__GNUC__)\n"
+        "#define NS_SIMD_LOOP _Pragma(\"GCC ivdep\")\n"
+        "#else\n"
+        "#define NS_SIMD_LOOP\n"
+        "#endif\n"
+    ),
+    "declare_simd": (
+        "#define NS_PRAGMA(x) _Pragma(#x)\n"
+        "#if defined(_OPENMP) || defined(NS_OPENMP_SIMD)\n"
+        "#define NS_DECLARE_SIMD(...) NS_PRAGMA(omp declare simd __VA_ARGS__)\n"
+        "#elif defined(__GNUC__) && !defined(__clang__)\n"
+        "#define NS_DECLARE_SIMD(...) __attribute__((simd(\"notinbranch\")))\n"
+        "#else\n"
+        "#define NS_DECLARE_SIMD(...)\n"
+        "#endif\n"
+    ),
+    "hot_cold": (
+        "#if defined(__GNUC__) && defined(__ELF__)\n"
+        "#define NS_HOT __attribute__((hot, section(\".text.hot\")))\n"
+        "#define NS_COLD __attribute__((cold, section(\".text.unlikely\")))\n"
+        "#elif defined(__GNUC__)\n"
+        "#define NS_HOT __attribute__((hot))\n"
+        "#define NS_COLD __attribute__((cold))\n"
+        "#else\n"
+        "#define NS_HOT\n"
+        "#define NS_COLD\n"
+        "#endif\n"
+    ),
+    "stdarg": "#include <stdarg.h>\n",
+    "cold_path": (
+        "#if defined(__GNUC__)\n"
+        "#define NS_COLD_PATH __attribute__((cold, noinline))\n"
+        "#define NS_COLD_NORETURN __attribute__((cold, noinline, noreturn))\n"
+        "#define NS_PRINTF_FORMAT(string_index, first_to_check) __attribute__((__format__(__printf__, string_index, first_to_check)))\n"
+        "#else\n"
+        "#define NS_COLD_PATH\n"
+        "#define NS_COLD_NORETURN\n"
+        "#define NS_PRINTF_FORMAT(string_index, first_to_check)\n"
+        "#endif\n"
+    ),
+    "call_counts": (
+        "#include <stdio.h>\n"
+        "#include <stdlib.h>\n"
+        "static unsigned long long ns_call_counts[NS_METHOD_COUNT];\n"
+        "#define NS_COUNT_CALL(id) __atomic_fetch_add(&ns_call_counts[id], 1, __ATOMIC_RELAXED)\n"
+        "__attribute__((destructor)) static void ns_call_counts_dump(void) {\n"
+        "    const char *path = getenv(\"NS_PROFILE_OUT\");\n"
+        "    FILE *out = fopen(path ? path : \"ns_profile.txt\", \"a\");\n"
+        "    if (!out) return;\n"
+        "    for (int i = 0; i < NS_METHOD_COUNT; i++)\n"
+        "        fprintf(out, \"%s %llu\\n\", ns_method_names[i], ns_call_counts[i]);\n"
+        "    fclose(out);\n"
+        "}\n"
+    ),
+    "latency": r"""#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(NS_LATENCY_RDTSC) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define NS_LATENCY_NOW() ((uint64_t)__rdtsc())
+#else
+static inline uint64_t ns_latency_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#define NS_LATENCY_NOW() ns_latency_now()
+#endif
+// Log-linear buckets: exact below 16, then 8 sub-buckets per power of two
+#define NS_LATENCY_BUCKETS 496
+typedef struct ns_latency_histogram {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint64_t buckets[NS_LATENCY_BUCKETS];
+} ns_latency_histogram;
+// Each thread records into its own block; blocks are never freed so snapshots can always walk them
+typedef struct ns_latency_block {
+    struct ns_latency_block *next;
+    ns_latency_histogram methods[NS_METHOD_COUNT];
+} ns_latency_block;
+static ns_latency_block *ns_latency_blocks;
+static __thread ns_latency_block *ns_latency_local;
+static inline unsigned ns_latency_bucket(uint64_t value) {
+    if (value < 16) return (unsigned)value;
+    unsigned exponent = 63 - (unsigned)__builtin_clzll(value);
+    return 16 + (exponent - 4) * 8 + (unsigned)((value >> (exponent - 3)) & 7);
+}
+static inline uint64_t ns_latency_bucket_limit(unsigned bucket) {
+    if (bucket < 16) return bucket;
+    unsigned exponent = (bucket - 16) / 8 + 4;
+    uint64_t sub = (bucket - 16) % 8;
+    return ((9 + sub) << (exponent - 3)) - 1;
+}
+static ns_latency_block *ns_latency_thread_block(void) {
+    ns_latency_block *block = calloc(1, sizeof *block);
+    if (!block) return NULL;
+    block->next = __atomic_load_n(&ns_latency_blocks, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&ns_latency_blocks, &block->next, block, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    ns_latency_local = block;
+    return block;
+}
+// Only the owning thread writes; relaxed atomics keep concurrent snapshots and resets well defined
+#define NS_LATENCY_ADD(field, value) __atomic_store_n(&(field), __atomic_load_n(&(field), __ATOMIC_RELAXED) + (value), __ATOMIC_RELAXED)
+static inline void ns_latency_record(int id, uint64_t elapsed) {
+    ns_latency_block *block = ns_latency_local;
+    if (__builtin_expect(!block, 0) && !(block = ns_latency_thread_block())) return;
+    ns_latency_histogram *histogram = &block->methods[id];
+    NS_LATENCY_ADD(histogram->buckets[ns_latency_bucket(elapsed)], 1);
+    NS_LATENCY_ADD(histogram->count, 1);
+    NS_LATENCY_ADD(histogram->sum, elapsed);
+    if (elapsed > __atomic_load_n(&histogram->max, __ATOMIC_RELAXED))
+        __atomic_store_n(&histogram->max, elapsed, __ATOMIC_RELAXED);
+}
+// Sums every thread's histograms into out, which holds NS_METHOD_COUNT entries indexed like ns_method_names
+__attribute__((unused)) static void ns_latency_snapshot(ns_latency_histogram *out) {
+    memset(out, 0, sizeof(ns_latency_histogram) * NS_METHOD_COUNT);
+    for (ns_latency_block *block = __atomic_load_n(&ns_latency_blocks, __ATOMIC_ACQUIRE); block; block = block->next) {
+        for (int id = 0; id < NS_METHOD_COUNT; id++) {
+            ns_latency_histogram *histogram = &block->methods[id];
+            for (int bucket = 0; bucket < NS_LATENCY_BUCKETS; bucket++)
+                out[id].buckets[bucket] += __atomic_load_n(&histogram->buckets[bucket], __ATOMIC_RELAXED);
+            out[id].count += __atomic_load_n(&histogram->count, __ATOMIC_RELAXED);
+            out[id].sum += __atomic_load_n(&histogram->sum, __ATOMIC_RELAXED);
+            uint64_t max = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+            if (max > out[id].max) out[id].max = max;
+        }
+    }
+}
+// Samples recorded while a reset runs may survive it
+__attribute__((unused)) static void ns_latency_reset(void) {
+    for (ns_latency_block *block = __atomic_load_n(&ns_latency_blocks, __ATOMIC_ACQUIRE); block; block = block->next) {
+        for (int id = 0; id < NS_METHOD_COUNT; id++) {
+            ns_latency_histogram *histogram = &block->methods[id];
+            for (int bucket = 0; bucket < NS_LATENCY_BUCKETS; bucket++)
+                __atomic_store_n(&histogram->buckets[bucket], 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&histogram->count, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&histogram->sum, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&histogram->max, 0, __ATOMIC_RELAXED);
+        }
+    }
+}
+// Upper bound of the bucket holding the given percentile (0-100), clamped to the recorded maximum
+__attribute__((unused)) static uint64_t ns_latency_percentile(const ns_latency_histogram *histogram, double percentile) {
+    if (!histogram->count) return 0;
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)histogram->count + 0.5);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (unsigned bucket = 0; bucket < NS_LATENCY_BUCKETS; bucket++) {
+        seen += histogram->buckets[bucket];
+        if (seen >= rank) {
+            uint64_t limit = ns_latency_bucket_limit(bucket);
+            return limit < histogram->max ? limit : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+__attribute__((unused)) static void ns_latency_report(FILE *out) {
+    ns_latency_histogram *snapshot = malloc(sizeof(ns_latency_histogram) * NS_METHOD_COUNT);
+    if (!snapshot) return;
+    ns_latency_snapshot(snapshot);
+    fprintf(out, "%-32s %12s %12s %12s %12s %12s %12s\n", "method", "count", "mean", "p50", "p90", "p99", "max");
+    for (int id = 0; id < NS_METHOD_COUNT; id++) {
+        const ns_latency_histogram *histogram = &snapshot[id];
+        if (!histogram->count) continue;
+        fprintf(out, "%-32s %12llu %12llu %12llu %12llu %12llu %12llu\n", ns_method_names[id],
+                (unsigned long long)histogram->count,
+                (unsigned long long)(histogram->sum / histogram->count),
+                (unsigned long long)ns_latency_percentile(histogram, 50),
+                (unsigned long long)ns_latency_percentile(histogram, 90),
+                (unsigned long long)ns_latency_percentile(histogram, 99),
+                (unsigned long long)histogram->max);
+    }
+    free(snapshot);
+}
+""",
+    "trace": r"""#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+// Events per thread, a power of two; events past a full ring are counted and dropped
+#ifndef NS_TRACE_RING_SIZE
+#define NS_TRACE_RING_SIZE 65536
+#endif
+typedef struct ns_trace_event {
+    uint64_t timestamp;
+    const char *method;
+    uint32_t phase;
+} ns_trace_event;
+// Single producer ring: the owning thread advances head, a flush advances tail
+typedef struct ns_trace_ring {
+    struct ns_trace_ring *next;
+    uint32_t thread_id;
+    // Owner only: open calls, and the depth of the outermost call whose events are being dropped
+    uint32_t depth;
+    uint32_t drop_depth;
+    uint64_t head;
+    uint64_t tail;
+    uint64_t dropped;
+    ns_trace_event events[NS_TRACE_RING_SIZE];
+} ns_trace_ring;
+// One registry per process: the weak definitions of every translation unit resolve to the same
+// objects, so all rings are written to a single trace by whichever unit's destructor runs first
+typedef struct ns_trace_registry {
+    ns_trace_ring *rings;
+    uint32_t threads;
+    int flushing;
+    int exited;
+} ns_trace_registry;
+__attribute__((weak)) ns_trace_registry ns_trace_shared;
+__attribute__((weak)) __thread ns_trace_ring *ns_trace_local;
+static inline uint64_t ns_trace_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+static ns_trace_ring *ns_trace_thread_ring(void) {
+    ns_trace_ring *ring = calloc(1, sizeof *ring);
+    if (!ring) return NULL;
+    ring->thread_id = __atomic_fetch_add(&ns_trace_shared.threads, 1, __ATOMIC_RELAXED) + 1;
+    ring->next = __atomic_load_n(&ns_trace_shared.rings, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&ns_trace_shared.rings, &ring->next, ring, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    ns_trace_local = ring;
+    return ring;
+}
+// A begin event is only recorded when the ring also has room for the end events of every open call,
+// so ends are never dropped; a dropped begin drops everything up to its own end to keep pairs matched
+static inline void ns_trace_emit(uint32_t method, char phase) {
+    ns_trace_ring *ring = ns_trace_local;
+    if (__builtin_expect(!ring, 0) && !(ring = ns_trace_thread_ring())) return;
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    int drop = ring->drop_depth != 0;
+    if (phase == 'B') {
+        ring->depth++;
+        if (!drop && head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) + ring->depth >= NS_TRACE_RING_SIZE) {
+            ring->drop_depth = ring->depth;
+            drop = 1;
+        }
+    } else {
+        if (ring->drop_depth == ring->depth) ring->drop_depth = 0;
+        ring->depth--;
+    }
+    if (drop) {
+        __atomic_store_n(&ring->dropped, __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+        return;
+    }
+    ns_trace_event *event = &ring->events[head & (NS_TRACE_RING_SIZE - 1)];
+    event->timestamp = ns_trace_now();
+    event->method = ns_method_names[method];
+    event->phase = (uint32_t)phase;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+// Writes and consumes every buffered event as one Chrome trace-event JSON document
+__attribute__((unused)) static void ns_trace_flush(FILE *out) {
+    while (__atomic_exchange_n(&ns_trace_shared.flushing, 1, __ATOMIC_ACQUIRE));
+    const char *separator = "";
+    uint64_t dropped = 0;
+    long pid = (long)getpid();
+    fprintf(out, "{\"traceEvents\":[");
+    for (ns_trace_ring *ring = __atomic_load_n(&ns_trace_shared.rings, __ATOMIC_ACQUIRE); ring; ring = ring->next) {
+        uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        for (uint64_t index = ring->tail; index != head; index++) {
+            const ns_trace_event *event = &ring->events[index & (NS_TRACE_RING_SIZE - 1)];
+            fprintf(out, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu.%03llu,\"pid\":%ld,\"tid\":%u}", separator,
+                    event->method, (char)event->phase,
+                    (unsigned long long)(event->timestamp / 1000), (unsigned long long)(event->timestamp % 1000),
+                    pid, ring->thread_id);
+            separator = ",";
+        }
+        __atomic_store_n(&ring->tail, head, __ATOMIC_RELEASE);
+        dropped += __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+    }
+    fprintf(out, "\n],\"otherData\":{\"dropped_events\":\"%llu\"}}\n", (unsigned long long)dropped);
+    __atomic_store_n(&ns_trace_shared.flushing, 0, __ATOMIC_RELEASE);
+}
+__attribute__((destructor)) static void ns_trace_flush_at_exit(void) {
+    if (__atomic_exchange_n(&ns_trace_shared.exited, 1, __ATOMIC_ACQ_REL)) return;
+    const char *path = getenv("NS_TRACE_OUT");
+    FILE *out = fopen(path ? path : "ns_trace.json", "w");
+    if (!out) return;
+    ns_trace_flush(out);
+    fclose(out);
+}
+""",
+    "perfcount": r"""#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__linux__)
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#define NS_PERF_COUNTERS 5
+static const char *const ns_perf_counter_names[NS_PERF_COUNTERS] = {
+    "cycles", "instructions", "l1d-misses", "llc-misses", "branch-misses",
+};
+// Counter values plus the time the group was enabled and actually running on the PMU
+typedef struct ns_perf_sample {
+    uint64_t values[NS_PERF_COUNTERS];
+    uint64_t enabled;
+    uint64_t running;
+} ns_perf_sample;
+// Per thread totals; blocks are never freed so reports can always walk them
+typedef struct ns_perf_block {
+    struct ns_perf_block *next;
+    uint64_t calls[NS_METHOD_COUNT];
+    // Calls whose counters were multiplexed with other events and scaled up to estimates
+    uint64_t scaled[NS_METHOD_COUNT];
+    uint64_t totals[NS_METHOD_COUNT][NS_PERF_COUNTERS];
+} ns_perf_block;
+static ns_perf_block *ns_perf_blocks;
+static int ns_perf_error;
+// Group leader fd, -2 before the thread opened its counters and -1 when they are unavailable
+static __thread int ns_perf_fd = -2;
+// Position of each counter in the group read, -1 for counters the kernel refused
+static __thread int ns_perf_slot[NS_PERF_COUNTERS];
+static __thread ns_perf_block *ns_perf_local;
+#if defined(__linux__)
+static int ns_perf_open_counter(uint32_t type, uint64_t config, int group) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof attr);
+    attr.size = sizeof attr;
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+static void ns_perf_open(void) {
+    static const uint32_t types[NS_PERF_COUNTERS] = {
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+    };
+    static const uint64_t configs[NS_PERF_COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+    };
+    ns_perf_fd = ns_perf_open_counter(types[0], configs[0], -1);
+    if (ns_perf_fd < 0) {
+        __atomic_store_n(&ns_perf_error, errno, __ATOMIC_RELAXED);
+        ns_perf_fd = -1;
+        return;
+    }
+    int slot = 0;
+    ns_perf_slot[0] = slot++;
+    for (int counter = 1; counter < NS_PERF_COUNTERS; counter++) {
+        int fd = ns_perf_open_counter(types[counter], configs[counter], ns_perf_fd);
+        ns_perf_slot[counter] = fd < 0 ? -1 : slot++;
+    }
+    ioctl(ns_perf_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+#endif
+static inline void ns_perf_read(ns_perf_sample *sample) {
+    memset(sample, 0, sizeof *sample);
+#if defined(__linux__)
+    if (__builtin_expect(ns_perf_fd == -2, 0)) ns_perf_open();
+    if (ns_perf_fd < 0) return;
+    // Layout: counter count, time enabled, time running, then one value per counter
+    uint64_t group[3 + NS_PERF_COUNTERS];
+    if (read(ns_perf_fd, group, sizeof group) < (ssize_t)(3 * sizeof(uint64_t))) return;
+    sample->enabled = group[1];
+    sample->running = group[2];
+    for (int counter = 0; counter < NS_PERF_COUNTERS; counter++)
+        if (ns_perf_slot[counter] >= 0 && (uint64_t)ns_perf_slot[counter] < group[0])
+            sample->values[counter] = group[3 + ns_perf_slot[counter]];
+#endif
+}
+static ns_perf_block *ns_perf_thread_block(void) {
+    ns_perf_block *block = calloc(1, sizeof *block);
+    if (!block) return NULL;
+    block->next = __atomic_load_n(&ns_perf_blocks, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&ns_perf_blocks, &block->next, block, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    ns_perf_local = block;
+    return block;
+}
+// Only the owning thread writes; relaxed atomics keep concurrent reports well defined
+#define NS_PERF_ADD(field, value) __atomic_store_n(&(field), __atomic_load_n(&(field), __ATOMIC_RELAXED) + (value), __ATOMIC_RELAXED)
+static inline void ns_perf_record(int id, const ns_perf_sample *start) {
+    ns_perf_sample end;
+    ns_perf_read(&end);
+    ns_perf_block *block = ns_perf_local;
+    if (__builtin_expect(!block, 0) && !(block = ns_perf_thread_block())) return;
+    NS_PERF_ADD(block->calls[id], 1);
+    // A group that shared the PMU only counted for part of the call; extrapolate to the enabled time
+    uint64_t enabled = end.enabled - start->enabled;
+    uint64_t running = end.running - start->running;
+    int multiplexed = running < enabled;
+    if (multiplexed) NS_PERF_ADD(block->scaled[id], 1);
+    for (int counter = 0; counter < NS_PERF_COUNTERS; counter++) {
+        uint64_t delta = end.values[counter] - start->values[counter];
+        if (multiplexed && running) delta = (uint64_t)((double)delta * (double)enabled / (double)running);
+        NS_PERF_ADD(block->totals[id][counter], delta);
+    }
+}
+// Prints per method totals summed over all threads, counters include nested calls; rows with
+// multiplexed calls are estimates and are flagged with how many calls were scaled
+__attribute__((unused)) static void ns_perf_report(FILE *out) {
+    int error = __atomic_load_n(&ns_perf_error, __ATOMIC_RELAXED);
+    if (error) fprintf(out, "hardware counters unavailable (%s), only call counts are exact\n", strerror(error));
+    fprintf(out, "%-32s %12s", "method", "calls");
+    for (int counter = 0; counter < NS_PERF_COUNTERS; counter++) fprintf(out, " %14s", ns_perf_counter_names[counter]);
+    fprintf(out, "\n");
+    for (int id = 0; id < NS_METHOD_COUNT; id++) {
+        uint64_t calls = 0;
+        uint64_t scaled = 0;
+        uint64_t totals[NS_PERF_COUNTERS] = {0};
+        for (ns_perf_block *block = __atomic_load_n(&ns_perf_blocks, __ATOMIC_ACQUIRE); block; block = block->next) {
+            calls += __atomic_load_n(&block->calls[id], __ATOMIC_RELAXED);
+            scaled += __atomic_load_n(&block->scaled[id], __ATOMIC_RELAXED);
+            for (int counter = 0; counter < NS_PERF_COUNTERS; counter++)
+                totals[counter] += __atomic_load_n(&block->totals[id][counter], __ATOMIC_RELAXED);
+        }
+        if (!calls) continue;
+        fprintf(out, "%-32s %12llu", ns_method_names[id], (unsigned long long)calls);
+        for (int counter = 0; counter < NS_PERF_COUNTERS; counter++) fprintf(out, " %14llu", (unsigned long long)totals[counter]);
+        if (scaled) fprintf(out, "  (estimated: %llu calls multiplexed)", (unsigned long long)scaled);
+        fprintf(out, "\n");
+    }
+}
+""",
+    "bench": (
+        "#include <stdint.h>\n"
+        "#include <stdio.h>\n"
+        "#include <stdlib.h>\n"
+        "#include <string.h>\n"
+        "#include <time.h>\n"
+        "#if defined(__linux__)\n"
+        "#include <sys/syscall.h>\n"
+        "#include <unistd.h>\n"
+        "#endif\n"
+    ),
+    "target_clones": (
+        "#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__ELF__)\n"
+        "#define NS_TARGET_CLONES(...) __attribute__((target_clones(__VA_ARGS__)))\n"
+        "#else\n"
+        "#define NS_TARGET_CLONES(...)\n"
+        "#endif\n"
+    ),
+    "dead_code": (
+        "#if defined(__GNUC__)\n"
+        "#define NS_DEAD_CODE static __attribute__((unused))\n"
+        "#else\n"
+        "#define NS_DEAD_CODE static\n"
+        "#endif\n"
+    ),
+    "export": (
+        "#if defined(_WIN32)\n"
+        "#define NS_EXPORT __declspec(dllexport)\n"
+        "#elif defined(__GNUC__)\n"
+        "#define NS_EXPORT __attribute__((visibility(\"default\")))\n"
+        "#else\n"
+        "#define NS_EXPORT\n"
+        "#endif\n"
+    ),
+    "internal_hidden": (
+        "#if defined(__GNUC__) && !defined(_WIN32)\n"
+        "#define NS_INTERNAL __attribute__((visibility(\"hidden\")))\n"
+        "#else\n"
+        "#define NS_INTERNAL\n"
+        "#endif\n"
+    ),
+    "internal_static": "#define NS_INTERNAL static\n",
+    "unroll": (
+        "#ifndef NS_PRAGMA\n"
+        "#define NS_PRAGMA(x) _Pragma(#x)\n"
+        "#endif\n"
+        "#if defined(__clang__)\n"
+        "#define NS_UNROLL(n) NS_PRAGMA(clang loop unroll_count(n))\n"
+        "#elif defined(__GNUC__) && __GNUC__ >= 8\n"
+        "#define NS_UNROLL(n) NS_PRAGMA(GCC unroll n)\n"
+        "#else\n"
+        "#define NS_UNROLL(n)\n"
+        "#endif\n"
+    ),
+    "wire": (
+        "#include <stddef.h>\n"
+        "#include <stdint.h>\n"
+        "#include <string.h>\n"
+        "#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__\n"
+        "#define NS_HOST_BIG_ENDIAN 1\n"
+        "#else\n"
+        "#define NS_HOST_BIG_ENDIAN 0\n"
+        "#endif\n"
+        "#if defined(__GNUC__)\n"
+        "#define NS_PACKED __attribute__((packed))\n"
+        "#define NS_BSWAP16(x) __builtin_bswap16(x)\n"
+        "#define NS_BSWAP32(x) __builtin_bswap32(x)\n"
+        "#define NS_BSWAP64(x) __builtin_bswap64(x)\n"
+        "#else\n"
+        "#define NS_PACKED\n"
+        "#define NS_BSWAP16(x) ((uint16_t)((uint16_t)(x) >> 8 | (uint16_t)(x) << 8))\n"
+        "#define NS_BSWAP32(x) ((uint32_t)NS_BSWAP16((uint16_t)(x)) << 16 | NS_BSWAP16((uint16_t)((x) >> 16)))\n"
+        "#define NS_BSWAP64(x) ((uint64_t)NS_BSWAP32((uint32_t)(x)) << 32 | NS_BSWAP32((uint32_t)((x) >> 32)))\n"
+        "#endif\n"
+        "static inline float ns_bswap_float(float value) {\n"
+        "    uint32_t bits;\n"
+        "    memcpy(&bits, &value, sizeof bits);\n"
+        "    bits = NS_BSWAP32(bits);\n"
+        "    memcpy(&value, &bits, sizeof bits);\n"
+        "    return value;\n"
+        "}\n"
+        "static inline double ns_bswap_double(double value) {\n"
+        "    uint64_t bits;\n"
+        "    memcpy(&bits, &value, sizeof bits);\n"
+        "    bits = NS_BSWAP64(bits);\n"
+        "    memcpy(&value, &bits, sizeof bits);\n"
+        "    return value;\n"
+        "}\n"
+    ),
+    "serializable": (
+        "#if NS_HOST_BIG_ENDIAN\n"
+        "#define NS_LE16(x) NS_BSWAP16(x)\n"
+        "#define NS_LE32(x) NS_BSWAP32(x)\n"
+        "#define NS_LE64(x) NS_BSWAP64(x)\n"
+        "#else\n"
+        "#define NS_LE16(x) (x)\n"
+        "#define NS_LE32(x) (x)\n"
+        "#define NS_LE64(x) (x)\n"
+        "#endif\n"
+    ),
+    "perfect_hash": (
+        "#include <stddef.h>\n"
+        "#include <stdint.h>\n"
+        "#include <string.h>\n"
+        "static inline uint32_t ns_fnv1a(const char *key, size_t length, uint32_t seed) {\n"
+        "    for (size_t i = 0; i < length; i++) seed = (seed ^ (unsigned char)key[i]) * 0x01000193u;\n"
+        "    return seed;\n"
+        "}\n"
+    ),
+    "json": r"""#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+static inline char *ns_json_write_u64(char *out, uint64_t value) {
+    static const char pairs[] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839404142434445464748495051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+    char digits[20];
+    char *end = digits + sizeof digits;
+    char *at = end;
+    while (value >= 100) {
+        at -= 2;
+        memcpy(at, pairs + value % 100 * 2, 2);
+        value /= 100;
+    }
+    if (value >= 10) {
+        at -= 2;
+        memcpy(at, pairs + value * 2, 2);
+    } else {
+        *--at = (char)('0' + value);
+    }
+    memcpy(out, at, (size_t)(end - at));
+    return out + (end - at);
+}
+static inline char *ns_json_write_i64(char *out, int64_t value) {
+    if (value < 0) {
+        *out++ = '-';
+        return ns_json_write_u64(out, 0 - (uint64_t)value);
+    }
+    return ns_json_write_u64(out, (uint64_t)value);
+}
+static inline char *ns_json_write_double(char *out, double value, int digits) {
+    if (value != value || value - value != 0) {
+        memcpy(out, "null", 4);
+        return out + 4;
+    }
+    return out + snprintf(out, 32, "%.*g", digits, value);
+}
+static inline char *ns_json_write_bool(char *out, int value) {
+    if (value) {
+        memcpy(out, "true", 4);
+        return out + 4;
+    }
+    memcpy(out, "false", 5);
+    return out + 5;
+}
+static inline char *ns_json_write_string(char *out, const char *text, size_t size) {
+    static const char hex[] = "0123456789abcdef";
+    *out++ = '"';
+    for (size_t i = 0; i < size && text[i]; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c == '"' || c == '\\') {
+            *out++ = '\\';
+            *out++ = (char)c;
+        } else if (c < 0x20) {
+            memcpy(out, "\\u00", 4);
+            out[4] = hex[c >> 4];
+            out[5] = hex[c & 15];
+            out += 6;
+        } else {
+            *out++ = (char)c;
+        }
+    }
+    *out++ = '"';
+    return out;
+}
+typedef struct ns_json_reader_s {
+    const char *at;
+    const char *end;
+} ns_json_reader_t;
+static inline void ns_json_space(ns_json_reader_t *reader) {
+    while (reader->at < reader->end && (*reader->at == ' ' || *reader->at == '\t' || *reader->at == '\n' || *reader->at == '\r')) reader->at++;
+}
+static inline int ns_json_expect(ns_json_reader_t *reader, char c) {
+    ns_json_space(reader);
+    if (reader->at < reader->end && *reader->at == c) {
+        reader->at++;
+        return 1;
+    }
+    return 0;
+}
+static inline int ns_json_read_key(ns_json_reader_t *reader, const char **key, size_t *length) {
+    if (!ns_json_expect(reader, '"')) return 0;
+    *key = reader->at;
+    while (reader->at < reader->end && *reader->at != '"') reader->at += *reader->at == '\\' ? 2 : 1;
+    if (reader->at >= reader->end) return 0;
+    *length = (size_t)(reader->at - *key);
+    reader->at++;
+    return 1;
+}
+static inline int ns_json_read_u64(ns_json_reader_t *reader, uint64_t max, uint64_t *value) {
+    ns_json_space(reader);
+    const char *start = reader->at;
+    uint64_t result = 0;
+    while (reader->at < reader->end && *reader->at >= '0' && *reader->at <= '9') {
+        unsigned digit = (unsigned)(*reader->at++ - '0');
+        if (result > (max - digit) / 10) return 0;
+        result = result * 10 + digit;
+    }
+    *value = result;
+    return reader->at != start;
+}
+static inline int ns_json_read_i64(ns_json_reader_t *reader, int64_t min, int64_t max, int64_t *value) {
+    ns_json_space(reader);
+    uint64_t magnitude;
+    if (reader->at < reader->end && *reader->at == '-') {
+        reader->at++;
+        if (!ns_json_read_u64(reader, 0 - (uint64_t)min, &magnitude)) return 0;
+        *value = magnitude ? -(int64_t)(magnitude - 1) - 1 : 0;
+        return 1;
+    }
+    if (!ns_json_read_u64(reader, (uint64_t)max, &magnitude)) return 0;
+    *value = (int64_t)magnitude;
+    return 1;
+}
+static inline int ns_json_read_double(ns_json_reader_t *reader, double *value) {
+    char number[64];
+    size_t length = 0;
+    ns_json_space(reader);
+    if (reader->end - reader->at >= 4 && memcmp(reader->at, "null", 4) == 0) {
+        reader->at += 4;
+        *value = NAN;
+        return 1;
+    }
+    while (reader->at < reader->end && length < sizeof number - 1 && strchr("+-.0123456789eE", *reader->at)) number[length++] = *reader->at++;
+    number[length] = '\0';
+    char *parsed;
+    *value = strtod(number, &parsed);
+    return length && parsed == number + length;
+}
+static inline int ns_json_read_bool(ns_json_reader_t *reader, int *value) {
+    ns_json_space(reader);
+    if (reader->end - reader->at >= 4 && memcmp(reader->at, "true", 4) == 0) {
+        reader->at += 4;
+        *value = 1;
+        return 1;
+    }
+    if (reader->end - reader->at >= 5 && memcmp(reader->at, "false", 5) == 0) {
+        reader->at += 5;
+        *value = 0;
+        return 1;
+    }
+    return 0;
+}
+static inline int ns_json_read_string(ns_json_reader_t *reader, char *out, size_t size) {
+    size_t length = 0;
+    if (!ns_json_expect(reader, '"')) return 0;
+    while (reader->at < reader->end && *reader->at != '"') {
+        char c = *reader->at++;
+        if (c == '\\') {
+            if (reader->at >= reader->end) return 0;
+            c = *reader->at++;
+            switch (c) {
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'n': c = '\n'; break;
+            case 'r': c = '\r'; break;
+            case 't': c = '\t'; break;
+            case 'u': {
+                if (reader->end - reader->at < 4) return 0;
+                char hex[5] = { reader->at[0], reader->at[1], reader->at[2], reader->at[3], '\0' };
+                char *parsed;
+                unsigned long code = strtoul(hex, &parsed, 16);
+                if (parsed != hex + 4 || code > 0x7f) return 0;
+                c = (char)code;
+                reader->at += 4;
+                break;
+            }
+            }
+        }
+        if (length >= size) return 0;
+        out[length++] = c;
+    }
+    if (reader->at >= reader->end) return 0;
+    reader->at++;
+    // A string filling all size bytes has no terminator, as the writer allows
+    memset(out + length, 0, size - length);
+    return 1;
+}
+static inline int ns_json_skip(ns_json_reader_t *reader, int depth) {
+    ns_json_space(reader);
+    if (reader->at >= reader->end || depth > 64) return 0;
+    char open = *reader->at;
+    if (open == '"') {
+        const char *key;
+        size_t length;
+        return ns_json_read_key(reader, &key, &length);
+    }
+    if (open == '{' || open == '[') {
+        char close = open == '{' ? '}' : ']';
+        reader->at++;
+        if (ns_json_expect(reader, close)) return 1;
+        do {
+            if (open == '{') {
+                const char *key;
+                size_t length;
+                if (!ns_json_read_key(reader, &key, &length) || !ns_json_expect(reader, ':')) return 0;
+            }
+            if (!ns_json_skip(reader, depth + 1)) return 0;
+        } while (ns_json_expect(reader, ','));
+        return ns_json_expect(reader, close);
+    }
+    const char *start = reader->at;
+    while (reader->at < reader->end && !strchr(",}] \t\r\n", *reader->at)) reader->at++;
+    return reader->at != start;
+}
+""",
+    "reflect": (
+        "#include <stddef.h>\n"
+        "typedef enum ns_type_code_e {\n"
+        "    NS_TYPE_OTHER,\n"
+        "    NS_TYPE_BOOL,\n"
+        "    NS_TYPE_CHAR,\n"
+        "    NS_TYPE_INT,\n"
+        "    NS_TYPE_UINT,\n"
+        "    NS_TYPE_FLOAT,\n"
+        "    NS_TYPE_STRUCT\n"
+        "} ns_type_code_t;\n"
+        "typedef struct ns_field_s {\n"
+        "    const char *name;\n"
+        "    const char *type_name;\n"
+        "    size_t offset;\n"
+        "    size_t size;\n"
+        "    size_t count;\n"
+        "    ns_type_code_t type;\n"
+        "    int ptr_level;\n"
+        "} ns_field_t;\n"
+    ),
+    "hashable": (
+        "#include <stdint.h>\n"
+        "#include <string.h>\n"
+        "static inline uint64_t ns_hash_mix(uint64_t hash, uint64_t word) {\n"
+        "    hash ^= word * 0xbf58476d1ce4e5b9u;\n"
+        "    return (hash << 27 | hash >> 37) * 0x94d049bb133111ebu;\n"
+        "}\n"
+        "static inline uint64_t ns_hash_finish(uint64_t hash) {\n"
+        "    hash ^= hash >> 31;\n"
+        "    hash *= 0x7fb5d329728ea185u;\n"
+        "    hash ^= hash >> 27;\n"
+        "    hash *= 0x81dadef4bc2dd44du;\n"
+        "    return hash ^ hash >> 33;\n"
+        "}\n"
+    ),
+    "branch_hints": (
+        "#if defined(__GNUC__)\n"
+        "#define NS_LIKELY(x) __builtin_expect(!!(x), 1)\n"
+        "#define NS_UNLIKELY(x) __builtin_expect(!!(x), 0)\n"
+        "#else\n"
+        "#define NS_LIKELY(x) (!!(x))\n"
+        "#define NS_UNLIKELY(x) (!!(x))\n"
+        "#endif\n"
+    ),
+    "musttail": (
+        "#if defined(__has_attribute)\n"
+        "#if __has_attribute(musttail)\n"
+        "#define NS_MUSTTAIL __attribute__((musttail))\n"
+        "#endif\n"
+        "#endif\n"
+        "#ifndef NS_MUSTTAIL\n"
+        "#define NS_MUSTTAIL\n"
+        "#endif\n"
+    ),
+}
 # Configure logging
 def setup_logging(verbose: bool):
     level = logging.DEBUG if verbose else logging.ERROR
@@ -29,6 +948,7 @@ class Variable:
     rest: Optional[str] = None
     array: Optional[str] = None
     value: Optional[str] = None
+    attributes: Dict[str, List[str]] = field(default_factory=dict)
 
 @dataclass
 class Method:
@@ -40,6 +960,7 @@ class Method:
     body: str
     has_self: bool
     ptr_level: int = 0
+    attributes: Dict[str, List[str]] = field(default_factory=dict)
 
 @dataclass
 class StructMetadata:
@@ -47,6 +968,7 @@ class StructMetadata:
     variables: List[Variable] = field(default_factory=list)
     methods: Dict[str, Method] = field(default_factory=dict)
     globals: Dict[str, Variable] = field(default_factory=dict)
+    attributes: Dict[str, List[str]] = field(default_factory=dict)
     done = False
 
 @dataclass
@@ -102,6 +1024,317 @@ def parse_variable_declaration(declaration: re.Match) -> Variable:
         keywords = keywords + " "
     return Variable(type=var_type, keywords = keywords, name=var_name, array=array, value=var_value,ptr_level = ptr_count)
 
+def parse_attributes(text: str) -> Dict[str, List[str]]:
+    """
+    Parses dialect attributes such as `@pure` or `@unroll(4)` into a name -> arguments mapping.
+
+    Args:
+        text (str): The attribute text preceding a declaration.
+
+    Returns:
+        Dict[str, List[str]]: The attribute names with their comma separated arguments.
+    """
+    attributes = {}
+    text = text or ""
+    for match in re.finditer(ATTRIBUTE_PATTERN, text):
+        if text[match.end():].lstrip(" \t").startswith('('):
+            raise TransformationError(f"Unbalanced or too deeply nested arguments in '{text[match.start():].splitlines()[0]}'.")
+        args = match.group(2)
+        parts = split_top_level(args, ',') if args else []
+        if parts is None:
+            raise TransformationError(f"Unbalanced arguments in '{match.group(0)}'.")
+        attributes[match.group(1)] = parts
+    return attributes
+
+def find_closing_bracket(text: str, open_index: int) -> int:
+    """
+    Finds the bracket closing the '(', '{' or '[' at open_index, skipping string and character literals.
+
+    Args:
+        text (str): The code to scan.
+        open_index (int): The index of the opening bracket.
+
+    Returns:
+        int: The index of the closing bracket, or -1 when it is unbalanced.
+    """
+    open_char = text[open_index]
+    close_char = {'(': ')', '{': '}', '[': ']'}[open_char]
+    depth = 0
+    i = open_index
+    while i < len(text):
+        char = text[i]
+        if char in "\"'":
+            i += 1
+            while i < len(text) and text[i] != char:
+                i += 2 if text[i] == '\\' else 1
+        elif char == open_char:
+            depth += 1
+        elif char == close_char:
+            depth -= 1
+            if depth == 0:
+                return i
+        i += 1
+    return -1
+
+def split_top_level(text: str, separator: str) -> Optional[List[str]]:
+    """
+    Splits code on a separator that is outside brackets and literals.
+
+    Args:
+        text (str): The code to split.
+        separator (str): The single character to split on, e.g. ',' or ';'.
+
+    Returns:
+        Optional[List[str]]: The stripped, non empty parts, or None when the brackets are unbalanced.
+    """
+    parts = []
+    depth = 0
+    current = []
+    i = 0
+    while i < len(text):
+        char = text[i]
+        if char in "\"'":
+            end = i + 1
+            while end < len(text) and text[end] != char:
+                end += 2 if text[end] == '\\' else 1
+            current.append(text[i:end + 1])
+            i = end + 1
+            continue
+        if char in "({[":
+            depth += 1
+        elif char in ")}]":
+            depth -= 1
+            if depth < 0:
+                return None
+        if char == separator and depth == 0:
+            parts.append(''.join(current).strip())
+            current = []
+        else:
+            current.append(char)
+        i += 1
+    if depth != 0:
+        return None
+    parts.append(''.join(current).strip())
+    return [part for part in parts if part]
+
+def signature_name(code: str, boundary: int, brace_index: int) -> Tuple[Optional[str], int]:
+    """
+    Extracts the function name from the text between a top level boundary and an opening brace.
+
+    Args:
+        code (str): The code being scanned.
+        boundary (int): The index after the previous top level declaration.
+        brace_index (int): The index of the opening brace.
+
+    Returns:
+        Tuple[Optional[str], int]: The function name, or None when the brace does not open a function,
+        and the start of the line holding the name.
+    """
+    close_index = len(code[:brace_index].rstrip()) - 1
+    if close_index < boundary or code[close_index] != ')':
+        return None, 0
+    depth = 0
+    open_index = close_index
+    while open_index >= boundary:
+        if code[open_index] == ')':
+            depth += 1
+        elif code[open_index] == '(':
+            depth -= 1
+            if depth == 0:
+                break
+        open_index -= 1
+    name = re.search(r"(\w+)\s*$", code[boundary:max(open_index, boundary)])
+    if open_index < boundary or not name or name.group(1) in CodeParser.CONTROL_STRUCTURES:
+        return None, 0
+    name_index = boundary + name.start(1)
+    return name.group(1), code.rfind('\n', 0, name_index) + 1
+
+def blank_comments_and_literals(code: str) -> str:
+    """
+    Blanks out comments and the contents of string and character literals, keeping every other
+    character (and newlines) in place so indices into the result are indices into the code.
+
+    Args:
+        code (str): The code to blank.
+
+    Returns:
+        str: The code with comment and literal text replaced by spaces.
+    """
+    blanked = list(code)
+    i = 0
+    while i < len(code):
+        if code.startswith('//', i):
+            end = code.find('\n', i)
+            end = len(code) if end < 0 else end
+        elif code.startswith('/*', i):
+            end = code.find('*/', i + 2)
+            end = len(code) if end < 0 else end + 2
+        elif code[i] in "\"'":
+            end = i + 1
+            while end < len(code) and code[end] != code[i] and code[end] != '\n':
+                end += 2 if code[end] == '\\' else 1
+            # The quotes stay so the literal remains an expression
+            for j in range(i + 1, min(end, len(code))):
+                if code[j] != '\n':
+                    blanked[j] = ' '
+            i = end + 1
+            continue
+        else:
+            i += 1
+            continue
+        for j in range(i, end):
+            if code[j] != '\n':
+                blanked[j] = ' '
+        i = end
+    return ''.join(blanked)
+
+def find_function_bodies(code: str) -> List[Tuple[str, int, int, int]]:
+    """
+    Finds the top level function definitions in generated C code.
+
+    Args:
+        code (str): The code to scan.
+
+    Returns:
+        List[Tuple[str, int, int, int]]: The function name, the start of its signature line,
+        and the indices of its opening and closing braces.
+    """
+    functions = []
+    depth = 0
+    boundary = 0
+    i = 0
+    while i < len(code):
+        char = code[i]
+        if code.startswith('//', i) or (char == '#' and depth == 0):
+            i = code.find('\n', i)
+            if i < 0:
+                break
+            if depth == 0:
+                boundary = i + 1
+        elif code.startswith('/*', i):
+            i = code.find('*/', i) + 1
+            if i <= 0:
+                break
+            if depth == 0:
+                boundary = i + 1
+        elif char in "\"'":
+            i += 1
+            while i < len(code) and code[i] != char:
+                i += 2 if code[i] == '\\' else 1
+        elif char == '{':
+            if depth == 0:
+                name, start = signature_name(code, boundary, i)
+                close_index = find_closing_bracket(code, i)
+                if name and close_index > 0:
+                    functions.append((name, start, i, close_index))
+                    i = close_index + 1
+                    boundary = i
+                    continue
+            depth += 1
+        elif char == '}':
+            depth -= 1
+            if depth == 0:
+                boundary = i + 1
+        elif char == ';' and depth == 0:
+            boundary = i + 1
+        i += 1
+    return functions
+
+def field_c_type(var: Variable) -> str:
+    """Returns the element type of a struct field or global without const, e.g. `unsigned int`."""
+    return f"{var.keywords.replace('const ', '')}{var.type}".strip()
+
+def field_layout(variables: List[Variable]) -> Optional[Tuple[List[Tuple[Variable, int, int, int]], int]]:
+    """
+    Lays out struct fields the way an LP64 C compiler does, aligning each field to its element size.
+
+    Args:
+        variables (List[Variable]): The fields in declaration order.
+
+    Returns:
+        Optional[Tuple[List[Tuple[Variable, int, int, int]], int]]: The field, offset, element size and
+        element count of every field with the padded struct size, or None when a field's size is unknown.
+    """
+    fields = []
+    offset = 0
+    alignment = 1
+    for var in variables:
+        size = 8 if var.ptr_level else C_TYPE_SIZES.get(field_c_type(var))
+        count = 1
+        if var.array:
+            dimension = var.array.strip("[] ")
+            count = int(dimension) if dimension.isdigit() else None
+        if size is None or count is None:
+            return None
+        offset = (offset + size - 1) // size * size
+        fields.append((var, offset, size, count))
+        offset += size * count
+        alignment = max(alignment, size)
+    return fields, (offset + alignment - 1) // alignment * alignment
+
+def fnv1a32(data: bytes, seed: int = 0x811c9dc5) -> int:
+    """Hashes bytes with 32 bit FNV-1a, the hash the generated C lookups compute as well."""
+    value = seed
+    for byte in data:
+        value = ((value ^ byte) * 0x01000193) & 0xffffffff
+    return value
+
+def perfect_hash(keys: List[str]) -> Tuple[List[int], List[int]]:
+    """
+    Builds a hash and displace minimal perfect hash over distinct keys.
+
+    A key's bucket is its FNV-1a hash scaled to the key count, and its slot is its FNV-1a hash
+    seeded with the bucket's seed, scaled the same way. Scaling by multiply and shift uses the
+    well mixed high bits of the hash rather than the low ones a modulo would.
+
+    Args:
+        keys (List[str]): The keys, at least one.
+
+    Returns:
+        Tuple[List[int], List[int]]: The seed of every bucket and the key index stored in every slot.
+    """
+    count = len(keys)
+    buckets: List[List[int]] = [[] for _ in range(count)]
+    for index, key in enumerate(keys):
+        buckets[fnv1a32(key.encode()) * count >> 32].append(index)
+    seeds = [0] * count
+    slots: List[Optional[int]] = [None] * count
+    for bucket in sorted(range(count), key=lambda b: len(buckets[b]), reverse=True):
+        if not buckets[bucket]:
+            break
+        for seed in range(1, 1 << 20):
+            targets = [fnv1a32(keys[index].encode(), seed) * count >> 32 for index in buckets[bucket]]
+            if len(set(targets)) == len(targets) and all(slots[target] is None for target in targets):
+                break
+        else:
+            raise TransformationError(f"No perfect hash found for {', '.join(keys)}.")
+        seeds[bucket] = seed
+        for index, target in zip(buckets[bucket], targets):
+            slots[target] = index
+    return seeds, slots
+
+def split_argument(arg: Dict[str, Optional[str]]) -> Tuple[str, str]:
+    """
+    Splits a parsed argument into its full C type and bare name, moving pointer stars and a single
+    array dimension onto the type.
+
+    Args:
+        arg (Dict[str, Optional[str]]): The argument as stored in Method.arguments.
+
+    Returns:
+        Tuple[str, str]: The argument type and the argument name.
+    """
+    arg_type = arg['type'] or ""
+    arg_name = arg['name']
+    stars = len(arg_name) - len(arg_name.lstrip('*'))
+    # An array parameter such as `int a[4]` is a pointer, and only its identifier names it
+    dimensions = re.findall(r"\[[^\]]*\]", arg_name)
+    if len(dimensions) == 1:
+        stars += 1
+    arg_name = re.sub(r"\s*\[[^\]]*\]", "", arg_name)
+    arg_type = (arg_type.strip() + ' ' + '*' * stars).strip() if stars else arg_type.strip()
+    return arg_type, arg_name.lstrip('*').strip()
+
 # Parser Class
 class CodeParser:
     """
@@ -110,8 +1343,10 @@ class CodeParser:
     """
     # Regex Patterns
     STRUCT_PATTERN = r"struct\s+(\w+)\s*\{((?:[^{}]*|\{[^{}]*\})*)\};"
-    METHOD_PATTERN = r"((?:^[^\r\n]*\/\/.*\r?\n)*\s*)^\s*(\w+)\s+((?:\*\s*)*)?@(\w+)\s*\(([^)]*)\)\s*\{([\s\S]*?)\};"
-    GLOBAL_PATTERN = r"((?:^[^\S\n]*\/\/.*$\r?\n)*)^[^\S\n\r]*\b(const\s+)?(unsigned\s+)?([a-zA-Z_][a-zA-Z0-9_]*)\s+((?:\*\s*)*)?@(\w+)(.*)?\s*;"
+    # A struct definition's opening line: `struct Name @attribute(args) {`
+    STRUCT_HEADER_PATTERN = rf"struct\s+(\w+)\s*((?:@\w+(?:\({ATTRIBUTE_ARGUMENTS}\))?\s*)*)\{{"
+    METHOD_PATTERN = rf"((?:^[^\r\n]*\/\/.*\r?\n)*\s*)^\s*((?:@\w+(?:\({ATTRIBUTE_ARGUMENTS}\))?\s+)*)((?:(?:const|unsigned|signed|long|short)\s+)*\w+)\s+((?:\*\s*)*)?@(\w+)\s*\(([^)]*)\)\s*\{{([\s\S]*?)\}};"
+    GLOBAL_PATTERN = rf"((?:^[^\S\n]*\/\/.*$\r?\n)*)^[^\S\n\r]*((?:@\w+(?:\({ATTRIBUTE_ARGUMENTS}\))?[^\S\n\r]+)*)\b(const\s+)?(unsigned\s+)?([a-zA-Z_][a-zA-Z0-9_]*)\s+((?:\*\s*)*)?@(\w+)(.*)?\s*;"
     FUNCTION_PATTERN = r'\b([a-zA-Z_][a-zA-Z0-9_\s\*]*)\s+([a-zA-Z_][a-zA-Z0-9_]*)\s*\(([^)]*)\)\s*\{([\s\S]*?)\}'
     CONTROL_STRUCTURES = {
         "if", "for", "while", "switch", "else", "do", "case", "default", "goto", "return", "break", "continue"
@@ -135,9 +1370,9 @@ class CodeParser:
         self.parse_globals()
 
     def parse_structs(self):
-        def extract_structs(code: str) -> List[Tuple[str, str]]:
+        def extract_structs(code: str) -> List[Tuple[str, str, str]]:
             structs = []
-            struct_pattern = re.compile(r'struct\s+(\w+)\s*\{')
+            struct_pattern = re.compile(self.STRUCT_HEADER_PATTERN)
 
             lines = code.split('\n')
             i = 0
@@ -145,6 +1380,7 @@ class CodeParser:
                 match = struct_pattern.match(lines[i])
                 if match:
                     struct_name = match.group(1)
+                    struct_attributes = match.group(2)
                     struct_body = []
                     brace_count = 1
                     i += 1
@@ -156,17 +1392,17 @@ class CodeParser:
                         i += 1
 
                     if brace_count == 0:
-                        structs.append((struct_name, '\n'.join(struct_body[:-1])))  # Exclude the closing brace
+                        structs.append((struct_name, struct_attributes, '\n'.join(struct_body[:-1])))  # Exclude the closing brace
                 else:
                     i += 1
 
             return structs
         """Parses structs, extracting their variables, methods, and global variables."""
         logger.info("Starting Struct Parsing")
-        for struct_name, struct_body in extract_structs(self.original_code):
+        for struct_name, struct_attributes, struct_body in extract_structs(self.original_code):
             logger.debug(f"Processing struct: {struct_name}")
 
-            metadata = StructMetadata()
+            metadata = StructMetadata(attributes=parse_attributes(struct_attributes))
             self.struct_metadata[struct_name] = metadata
 
             # Extract methods
@@ -175,6 +1411,10 @@ class CodeParser:
             print(f"struct body is {struct_body}")
             struct_body = re.sub(self.GLOBAL_PATTERN, lambda m: self.replace_global(m, struct_name, metadata), struct_body,flags=re.MULTILINE)
             print(f"globals struct body is {struct_body}")
+            # Attributes left over did not parse, e.g. arguments nested deeper than ATTRIBUTE_ARGUMENTS allows
+            stray = re.search(r"^\s*(@\w+.*)$", struct_body, re.MULTILINE)
+            if stray:
+                raise TransformationError(f"Unable to parse attribute '{stray.group(1).strip()}' in struct {struct_name}.")
 
             # Extract variables
             variable_matches = re.finditer(self.DECLARATION_PATTERN, struct_body)
@@ -191,12 +1431,13 @@ class CodeParser:
     def replace_method(self, match: re.Match, struct_name: str, metadata: StructMetadata) -> str:
         """Extracts method details and updates struct metadata."""
         comments = match.group(1)
-        return_type = match.group(2).strip()
-        pointers_type = match.group(3).strip()
+        attributes = parse_attributes(match.group(2))
+        return_type = match.group(3).strip()
+        pointers_type = match.group(4).strip()
         ptr_count = pointers_type.count("*")
-        method_name = match.group(4).strip()
-        args = match.group(5).strip()
-        body = match.group(6).strip()
+        method_name = match.group(5).strip()
+        args = match.group(6).strip()
+        body = match.group(7).strip()
 
         logger.debug(f"Extracting method: {method_name} from struct: {struct_name}")
 
@@ -223,7 +1464,8 @@ class CodeParser:
             arguments=parsed_args,
             body=body,
             has_self=has_self,
-            ptr_level=ptr_count
+            ptr_level=ptr_count,
+            attributes=attributes
         )
         metadata.methods[method_name] = method
 
@@ -234,20 +1476,22 @@ class CodeParser:
     def replace_global(self, match: re.Match, struct_name: str, metadata: StructMetadata) -> str:
         """Extracts global variable details and updates struct metadata."""
         comments = match.group(1).strip()
-        const = match.group(2).strip() if match.group(2) else ""
-        unsigned = match.group(3).strip() if match.group(3) else ""
-        var_type = match.group(4).strip()
-        pointer = match.group(5).strip() if match.group(5) else ""
+        attributes = parse_attributes(match.group(2))
+        const = match.group(3).strip() if match.group(3) else ""
+        unsigned = match.group(4).strip() if match.group(4) else ""
+        var_type = match.group(5).strip()
+        pointer = match.group(6).strip() if match.group(6) else ""
         ptr_count = pointer.count("*")
-        var_name = match.group(6).strip()
-        rest = match.group(7).strip() if match.group(7) else ""
+        var_name = match.group(7).strip()
+        rest = match.group(8).strip() if match.group(8) else ""
 
         keywords = " ".join(filter(None, [const, unsigned]))
         if len(keywords) != 0:
             keywords = keywords + ' '
         logger.debug(f"Extracting global variable: {var_name} from struct: {struct_name}")
 
-        variable = Variable(type=var_type, name=var_name, keywords=keywords, comments=comments,ptr_level=ptr_count,rest=rest)
+        variable = Variable(type=var_type, name=var_name, keywords=keywords, comments=comments,ptr_level=ptr_count,rest=rest,
+                            attributes=attributes)
         metadata.globals[var_name] = variable
 
         logger.debug(f"Stored global variable metadata for '{var_name}': {variable}")
@@ -329,6 +1573,19 @@ class CodeGenerator:
     Handles method call refactoring and global variable replacement.
     """
     METHOD_CALL_PATTERN = r"((?:\*)*)?(\b[a-zA-Z_][a-zA-Z0-9_]*@(?:\w+))\s*\(([^)]*)\)"
+    # Methods are hot until they cover this share of all profiled calls
+    PROFILE_HOT_FRACTION = 0.9
+    SIMD_INDEX_NAME_PATTERN = r"(?:[ijk]|idx|index|\w+_(?:idx|index))"
+    SIMD_INDEX_TYPE_PATTERN = r"\b(?:int|long|short|unsigned|size_t|ssize_t|ptrdiff_t|u?int\d+_t)\b"
+    BRANCH_HINT_PATTERN = r"(?<![\w.>])\b(likely|unlikely)\s*\("
+    SPECIALIZE_LITERAL_PATTERN = r"^(?:-\s*)?(?:0[xX][0-9a-fA-F]+|\d+(?:\.\d*)?(?:[eE][+-]?\d+)?)[uUlLfF]*$|^'(?:\\.|[^'\\])'$|^(?:true|false)$"
+    UNROLL_PATTERN = r"@unroll(?:\(\s*([^)]*?)\s*\))?\s*(?=for\s*\()"
+    LOOP_INIT_PATTERN = r"^(?:((?:(?:const|unsigned|signed|long|short)\s+)*\w+)\s+)?(\w+)\s*=\s*([\s\S]+)$"
+    LOOP_CONDITION_PATTERN = r"^(\w+)\s*(<=|>=|<|>|!=)\s*([\s\S]+)$"
+    LOOP_STEP_PATTERN = r"^(?:(\+\+|--)\s*(\w+)|(\w+)\s*(\+\+|--)|(\w+)\s*([-+])=\s*([\s\S]+))$"
+    # Loops with a constant trip count up to this many iterations are unrolled completely
+    MAX_FULL_UNROLL = 64
+    BROADCAST_CALL_PATTERN = r"^(\s*)\b([a-zA-Z_][a-zA-Z0-9_]*)\s*\[\s*([^\]]+?)\s*\.\.\s*([^\]]+?)\s*\]\s*@(\w+)\s*\(([^)]*)\)\s*;"
 
     def __init__(self, 
                  original_code: str, 
@@ -336,7 +1593,15 @@ class CodeGenerator:
                  functions_metadata: Dict[str, FunctionMetadata], 
                  global_variables: List[Variable],
                  hierarchy: Hierarchy,
-                 declare_in_place = False):
+                 declare_in_place = False,
+                 outline_cold = False,
+                 instrument: Optional[List[str]] = None,
+                 instrument_filter: Optional[List[str]] = None,
+                 profile: Optional[Dict[str, int]] = None,
+                 bench = False,
+                 dead_code = "keep",
+                 entries: Optional[List[str]] = None,
+                 visibility = "default"):
         self.original_code = original_code
         self.struct_metadata = struct_metadata
         self.functions_metadata = functions_metadata
@@ -344,17 +1609,51 @@ class CodeGenerator:
         self.hierarchy = hierarchy
         self.transformed_code = original_code  # Initialize with original code
         self.declare_in_place = declare_in_place
+        self.outline_cold = outline_cold
+        self.instrument = instrument or []
+        self.instrument_filter = instrument_filter or ["*"]
+        self.profile = profile
+        self.bench = bench
+        self.dead_code = dead_code
+        self.entries = entries or []
+        self.visibility = visibility
+        self.exported_methods: List[str] = []
+        # Generated symbols with external linkage that --version_script hides
+        self.internal_symbols: List[str] = []
+        self.dead_methods: Set[str] = set()
+        self.dead_globals: Set[str] = set()
+        self.specializations: Dict[Tuple[str, str], List[Tuple[Tuple[str, str], ...]]] = {}
+        self.constants: Dict[str, Tuple[object, 'CType']] = {}
+        self.evaluating: Set[str] = set()
+        self.constexpr_results: Dict = {}
+        self.instrumented_methods: List[str] = []
         self.pre_declarations = []
+        self.support = []
+        self.broadcast_count = 0
+
+    def require_support(self, name: str):
+        """Marks a SUPPORT_CODE snippet as needed by the generated code, emitting it only once."""
+        if name not in self.support:
+            self.support.append(name)
 
     def generate(self) -> str:
         """Generates the transformed code by applying all necessary replacements."""
         logger.info("Starting Code Generation")
+        if self.profile is not None:
+            logger.info("Applying profile")
+            self.apply_profile()
+        if self.dead_code != "keep":
+            logger.info("Eliminating dead methods and globals")
+            self.eliminate_dead_code()
         # Step 1: Replace all type usage with well defined _t precode
         logger.info("Fixing Types")
         self.fix_types();
+        self.collect_specializations()
         # Step 2: Replace Structs with transformed structs and methods
         logger.info("Replacing Structs")
         self.transformed_code = self.replace_structs()
+        logger.info("Unrolling loops")
+        self.transformed_code = self.unroll_loops(self.transformed_code)
         # Step 3: Refactor method calls with scope-aware replacements
         logger.info("Refactoring calls")
         self.transformed_code = self.refactor_method_calls_with_scope(self.transformed_code)
@@ -363,10 +1662,21 @@ class CodeGenerator:
         self.transformed_code = self.replace_globals(self.transformed_code)
         self.transformed_code = self.replace_typecasts(self.transformed_code)
         self.transformed_code = self.replace_function_pointer(self.transformed_code)
+        self.transformed_code = self.replace_branch_hints(self.transformed_code)
+        # Step 5: Move error exit branches out of hot bodies
+        if self.outline_cold:
+            logger.info("Outlining cold paths")
+            outliner = ColdPathOutliner()
+            self.transformed_code = outliner.outline(self.transformed_code)
+            for name in outliner.used_support:
+                self.require_support(name)
+        if self.bench:
+            logger.info("Generating benchmark runner")
+            self.transformed_code = self.generate_bench_runner(self.transformed_code)
 
         ## TODO @(dleiferives,7bbd9fd5-1b00-4f1c-bd20-48f312ec72ac): good place
         ## for header generation refactor ~#
-        # Step 5: Generate declarations if need
+        # Step 6: Generate declarations if need
         # typedefs
         # function pointers
         # normal structs
@@ -378,6 +1688,12 @@ class CodeGenerator:
         if not self.declare_in_place:
             logger.info("Inserting Declarations")
             self.transformed_code = "".join(self.pre_declarations) + self.transformed_code
+        # Step 7: Support code needed by generated constructs goes before everything else
+        if self.support:
+            logger.info("Inserting Support Code")
+            self.transformed_code = "".join(SUPPORT_CODE[name] for name in self.support) + self.transformed_code
+        if self.instrumented_methods:
+            self.transformed_code = self.instrumented_method_table() + self.transformed_code
 
         logger.info("Completed Code Generation")
         return self.transformed_code
@@ -387,7 +1703,7 @@ class CodeGenerator:
         def fix_variable(var, name):
             print(f"checking var {var.type}")
             if var.type == name:
-                var.type = struct_name + "_t"
+                var.type = name + "_t"
             return var
 
         def fix_variables(vars: List, name):
@@ -465,7 +1781,7 @@ class CodeGenerator:
         new_code_lines = []
         i = 0
         n = len(code_lines)
-        struct_pattern = re.compile(r'struct\s+(\w+)\s*\{')
+        struct_pattern = re.compile(CodeParser.STRUCT_HEADER_PATTERN)
 
         while i < n:
             line = code_lines[i]
@@ -520,7 +1836,7 @@ class CodeGenerator:
 
                     # Reconstruct the struct without methods and globals
                     struct_vars = [
-                        f"{var.keywords} {var.type} {'*' * var.ptr_level}{var.name};"
+                        f"{var.keywords} {var.type} {'*' * var.ptr_level}{var.name}{var.array or ''};"
                         for var in metadata.variables
                     ]
                     struct_body_reconstructed = '\n    '.join(struct_vars)
@@ -542,41 +1858,82 @@ class CodeGenerator:
                             )
                             transformed_structs.append(transpiled_struct)
                         logger.debug(f"Transpiled struct for {struct_name} added.")
-
-                    # Handle globals if any
-                    if metadata.globals:
+                    if "wire" in metadata.attributes:
+                        transformed_structs.append(self.generate_wire_codec(struct_name, metadata))
+                    if "serializable" in metadata.attributes:
+                        transformed_structs.append(self.generate_serializer(struct_name, metadata))
+                    if "json" in metadata.attributes:
+                        transformed_structs.append(self.generate_json_codec(struct_name, metadata))
+                    if self.reflects(struct_name):
+                        transformed_structs.append(self.generate_reflection(struct_name, metadata))
+                    if "hashable" in metadata.attributes:
+                        transformed_structs.append(self.generate_hash_functions(struct_name, metadata))
+                    if "lookup" in metadata.attributes or re.search(rf"\b{struct_name}_find_(?:method|field)\b", self.original_code):
+                        transformed_structs.append(self.generate_name_lookups(struct_name, metadata))
+
+                    # Tables are computed here and become read only arrays of their own
+                    struct_globals = {name: var for name, var in metadata.globals.items() if "table" not in var.attributes}
+                    for var in metadata.globals.values():
+                        if "table" in var.attributes:
+                            transformed_structs.append(self.generate_table(struct_name, var))
+
+                    # Handle globals if any; dead globals sharing the struct with live ones get their own object
+                    objects: Dict[str, Dict[str, Variable]] = {}
+                    for name, var in struct_globals.items():
+                        objects.setdefault(self.globals_object(struct_name, name), {})[name] = var
+                    for object_name, object_globals in objects.items():
                         globals_body = []
-                        for var in metadata.globals.values():
+                        for var in object_globals.values():
                             var_declaration = f"    {var.keywords} {var.type} {'*' * var.ptr_level}{var.name};"
                             if var.comments:
                                 globals_body.append(f"{var.comments}\n{var_declaration}")
                             else:
                                 globals_body.append(var_declaration)
                         globals_body_reconstructed = '\n'.join(globals_body)
+                        # @constexpr globals start out with their transpile time value
+                        initial_values = []
+                        for name, var in object_globals.items():
+                            if "constexpr" in var.attributes:
+                                value, ctype = self.resolve_constant(f"{struct_name}@{name}")
+                                initial_values.append(f".{name} = {ConstantEvaluator().format_constant(value, ctype)}")
+                        globals_initializer = f" = {{ {', '.join(initial_values)} }}" if initial_values else ""
+                        globals_storage = ""
+                        if all(f"{struct_name}@{name}" in self.dead_globals for name in object_globals):
+                            self.require_support("dead_code")
+                            globals_storage = "NS_DEAD_CODE "
+                        else:
+                            self.internal_symbols.append(object_name)
                         if not self.declare_in_place:
                             globals_struct = (
-                                f"struct {struct_name}_globals_s {{\n{globals_body_reconstructed}\n}};\n"
-                                f"{struct_name}_globals_t {struct_name}_globals;\n"
+                                f"struct {object_name}_s {{\n{globals_body_reconstructed}\n}};\n"
+                                f"{globals_storage}{object_name}_t {object_name}{globals_initializer};\n"
                             )
                             transformed_structs.append(globals_struct)
                             globals_struct = (
-                                f"typedef struct {struct_name}_globals_s {struct_name}_globals_t;\n"
+                                f"typedef struct {object_name}_s {object_name}_t;\n"
                             )
                             self.pre_declarations.append(globals_struct)
                         else:
                             globals_struct = (
-                                f"typedef struct {struct_name}_globals_s {struct_name}_globals_t;\n"
-                                f"struct {struct_name}_globals_s {{\n{globals_body_reconstructed}\n}};\n"
-                                f"{struct_name}_globals_t {struct_name}_globals;\n"
+                                f"typedef struct {object_name}_s {object_name}_t;\n"
+                                f"struct {object_name}_s {{\n{globals_body_reconstructed}\n}};\n"
+                                f"{globals_storage}{object_name}_t {object_name}{globals_initializer};\n"
                             )
                             transformed_structs.append(globals_struct)
-                        logger.debug(f"Globals struct for {struct_name} added.")
+                        logger.debug(f"Globals struct {object_name} added.")
 
-                    # Generate transformed methods
-                    for method in metadata.methods.values():
+                    # Generate transformed methods, hottest first when a profile is available
+                    methods = list(metadata.methods.values())
+                    if self.profile is not None and not self.declare_in_place:
+                        methods.sort(key=lambda m: self.profile.get(f"{struct_name}@{m.name}", 0), reverse=True)
+                    for method in methods:
                         transformed_method = self.generate_transformed_method(struct_name, method)
                         transformed_structs.append(transformed_method)
                         logger.debug(f"Transformed method for {struct_name}: {method.name} added.")
+                        for constants in self.specializations.get((struct_name, method.name), []):
+                            clone = self.specialized_method(method, constants)
+                            transformed_structs.append(self.generate_transformed_method(struct_name, clone))
+                            logger.debug(f"Specialized method for {struct_name}: {clone.name} added.")
 
                     # Mark the struct as processed
                     metadata.done = True
@@ -598,6 +1955,619 @@ class CodeGenerator:
         logger.debug("Structs replaced successfully")
         return code_with_updated_structs
 
+    def constant_evaluator(self) -> 'ConstantEvaluator':
+        """Creates an evaluator that sees the @table and @constexpr globals and the @constexpr methods."""
+        methods = {}
+        for struct_name, metadata in self.struct_metadata.items():
+            for method in metadata.methods.values():
+                if "constexpr" in method.attributes and not method.has_self:
+                    methods[f"{struct_name}@{method.name}"] = method
+        return ConstantEvaluator(self.resolve_constant, methods, self.constexpr_results, self.constant_type)
+
+    def constant_type(self, qualified_name: str) -> 'CType':
+        """Looks up the declared type of a @table or @constexpr global without computing its value."""
+        struct_name, _, name = qualified_name.partition('@')
+        var = self.struct_metadata.get(struct_name, StructMetadata()).globals.get(name)
+        if not var or not ("table" in var.attributes or "constexpr" in var.attributes):
+            raise TransformationError(f"'{qualified_name}' is not a @table or @constexpr global.")
+        return ConstantEvaluator().parse_type(f"{var.keywords}{var.type}")
+
+    def resolve_constant(self, qualified_name: str) -> Tuple[object, 'CType']:
+        """
+        Looks up a global used in a constant expression, computing it on first use.
+
+        Args:
+            qualified_name (str): The global as Type@name.
+
+        Returns:
+            Tuple[object, CType]: The element list of a @table or the value of a @constexpr global, and its type.
+        """
+        if qualified_name in self.constants:
+            return self.constants[qualified_name]
+        struct_name, _, name = qualified_name.partition('@')
+        var = self.struct_metadata.get(struct_name, StructMetadata()).globals.get(name)
+        if not var or not ("table" in var.attributes or "constexpr" in var.attributes):
+            raise TransformationError(f"'{qualified_name}' is not a @table or @constexpr global.")
+        if qualified_name in self.evaluating:
+            raise TransformationError(f"'{qualified_name}' depends on itself.")
+        initializer = re.sub(r"^=\s*", "", var.rest or "")
+        if not initializer or initializer == var.rest or var.ptr_level:
+            raise TransformationError(f"'{qualified_name}' needs an arithmetic type and an initializer.")
+        self.evaluating.add(qualified_name)
+        evaluator = self.constant_evaluator()
+        element_type = evaluator.parse_type(f"{var.keywords}{var.type}")
+        expression = evaluator.parse(initializer)
+        if "table" in var.attributes:
+            if len(var.attributes["table"]) != 1:
+                raise TransformationError(f"@table '{qualified_name}' needs a size, as in @table(256).")
+            size, _ = evaluator.evaluate(var.attributes["table"][0])
+            value = []
+            for index in range(size):
+                value.append(evaluator.convert(evaluator.evaluate_parsed(expression, {"i": (index, ConstantEvaluator.INT)})[0], element_type))
+            logger.debug(f"Computed {size} elements of @table {qualified_name}")
+        else:
+            value = evaluator.convert(evaluator.evaluate_parsed(expression)[0], element_type)
+            logger.debug(f"Computed @constexpr {qualified_name} = {value}")
+        self.evaluating.discard(qualified_name)
+        self.constants[qualified_name] = (value, element_type)
+        return self.constants[qualified_name]
+
+    def fold_constexpr_call(self, struct_name: str, method: Method, args: str) -> Optional[str]:
+        """
+        Evaluates a call of a @constexpr method whose arguments are all constant.
+
+        Args:
+            struct_name (str): The name of the struct.
+            method (Method): The called method.
+            args (str): The call arguments.
+
+        Returns:
+            Optional[str]: The result as a C literal, or None when the call has to run at runtime.
+        """
+        if method.has_self:
+            logger.warning(f"@constexpr {struct_name}@{method.name} takes self and is never folded.")
+            return None
+        arg_list = split_top_level(args, ',') if args.strip() else []
+        if arg_list is None:
+            return None
+        evaluator = self.constant_evaluator()
+        try:
+            values = [evaluator.evaluate(arg) for arg in arg_list]
+            value, ctype = evaluator.call(f"{struct_name}@{method.name}", values)
+        except TransformationError as e:
+            logger.debug(f"Not folding {struct_name}@{method.name}({args}): {e}")
+            return None
+        literal = evaluator.format_constant(value, ctype)
+        return f"({literal})" if literal.startswith('-') else literal
+
+    def globals_object(self, struct_name: str, name: str) -> str:
+        """
+        Names the object holding a global. With --dead_code mark, dead globals of a struct that also
+        has live ones move to Type_dead_globals so only they are marked static and unused.
+
+        Args:
+            struct_name (str): The name of the struct.
+            name (str): The name of the global.
+
+        Returns:
+            str: Type_globals or Type_dead_globals.
+        """
+        struct_globals = [member for member, var in self.struct_metadata[struct_name].globals.items()
+                          if "table" not in var.attributes]
+        dead = [member for member in struct_globals if f"{struct_name}@{member}" in self.dead_globals]
+        if name in dead and len(dead) < len(struct_globals):
+            return f"{struct_name}_dead_globals"
+        return f"{struct_name}_globals"
+
+    def generate_table(self, struct_name: str, var: Variable) -> str:
+        """
+        Emits a @table global as a static const array, which the compiler places in .rodata.
+
+        Args:
+            struct_name (str): The name of the struct.
+            var (Variable): The table global.
+
+        Returns:
+            str: The array definition.
+        """
+        values, element_type = self.resolve_constant(f"{struct_name}@{var.name}")
+        storage = "static const"
+        if f"{struct_name}@{var.name}" in self.dead_globals:
+            self.require_support("dead_code")
+            storage = "NS_DEAD_CODE const"
+        element_c_type = f"{var.keywords.replace('const ', '')}{var.type}"
+        # No early declaration: the pre declarations precede the user's includes, which may define the element type,
+        # and the definition already comes before every method using the table
+        declaration = f"{storage} {element_c_type} {struct_name}_{var.name}[{len(values)}]"
+        literals = [ConstantEvaluator().format_constant(value, element_type) for value in values]
+        rows = ''.join(f"    {', '.join(literals[row:row + 8])},\n" for row in range(0, len(literals), 8))
+        comments = f"{var.comments}\n" if var.comments else ""
+        return f"{comments}{declaration} = {{\n{rows}}};\n"
+
+    def generate_wire_codec(self, struct_name: str, metadata: StructMetadata) -> str:
+        """
+        Emits the packed wire layout of a @wire(big|little) struct with array decode and encode functions.
+
+        The functions convert `count` records per call. On hosts with the wire byte order they compile to
+        a memcpy when the native layout has no padding, otherwise to a byte swapping loop per field.
+
+        Args:
+            struct_name (str): The name of the struct.
+            metadata (StructMetadata): The struct metadata.
+
+        Returns:
+            str: The wire struct and codec definitions.
+        """
+        order = (metadata.attributes["wire"] or ["big"])[0]
+        if order not in ("big", "little"):
+            raise TransformationError(f"@wire on '{struct_name}' takes big or little, not '{order}'.")
+        layout = field_layout(metadata.variables)
+        if not metadata.variables or layout is None or any(var.ptr_level for var in metadata.variables):
+            raise TransformationError(f"@wire struct '{struct_name}' needs fixed size arithmetic fields.")
+        fields, native_size = layout
+        wire_size = sum(size * count for _, _, size, count in fields)
+        self.require_support("wire")
+
+        wire_fields = '\n'.join(f"    {field_c_type(var)} {var.name}{var.array or ''};" for var, _, _, _ in fields)
+        decode = f"void {struct_name}_decode({struct_name}_t *out, const {struct_name}_wire_t *in, size_t count)"
+        encode = f"void {struct_name}_encode({struct_name}_wire_t *out, const {struct_name}_t *in, size_t count)"
+        if not self.declare_in_place:
+            self.pre_declarations.append(f"typedef struct {struct_name}_wire_s {struct_name}_wire_t;\n")
+            self.pre_declarations.append(f"{decode};\n{encode};\n")
+        wire_struct = f"struct {struct_name}_wire_s {{\n{wire_fields}\n}} NS_PACKED;\n"
+        if self.declare_in_place:
+            wire_struct = f"typedef struct {struct_name}_wire_s {struct_name}_wire_t;\n" + wire_struct
+
+        def conversions(swap: bool) -> str:
+            lines = []
+            for var, _, size, count in fields:
+                element = f"{var.name}[ns_k]" if var.array else var.name
+                value = f"in[ns_n].{element}"
+                c_type = field_c_type(var)
+                if swap and c_type in ("float", "double"):
+                    value = f"ns_bswap_{c_type}({value})"
+                elif swap and size > 1:
+                    value = f"({c_type})NS_BSWAP{size * 8}((uint{size * 8}_t){value})"
+                statement = f"out[ns_n].{element} = {value};"
+                if var.array:
+                    statement = f"for (size_t ns_k = 0; ns_k < {count}; ns_k++) {statement}"
+                lines.append(f"        {statement}\n")
+            return f"    for (size_t ns_n = 0; ns_n < count; ns_n++) {{\n{''.join(lines)}    }}\n"
+
+        same_order = "NS_HOST_BIG_ENDIAN" if order == "big" else "!NS_HOST_BIG_ENDIAN"
+        if wire_size == native_size:
+            direct = (
+                f"    _Static_assert(sizeof({struct_name}_t) == sizeof({struct_name}_wire_t), \"{struct_name} has padding\");\n"
+                f"    memcpy(out, in, count * sizeof *out);\n"
+            )
+        else:
+            direct = conversions(False)
+        return wire_struct + ''.join(
+            f"{signature} {{\n#if {same_order}\n{direct}#else\n{conversions(True)}#endif\n}}\n"
+            for signature in (decode, encode)
+        )
+
+    def generate_serializer(self, struct_name: str, metadata: StructMetadata) -> str:
+        """
+        Emits the flat binary format of a @serializable struct: Type_serialize and a zero copy Type_view.
+
+        A serialized record is a little endian 32 bit schema hash, its 32 bit payload size and the
+        fields, little endian at their LP64 offsets. Type_view checks the hash and size, and the
+        Type_view_<field> accessors then read single fields straight out of the buffer.
+
+        Args:
+            struct_name (str): The name of the struct.
+            metadata (StructMetadata): The struct metadata.
+
+        Returns:
+            str: The schema constants, view type, accessors and functions.
+        """
+        layout = field_layout(metadata.variables)
+        if not metadata.variables or layout is None or any(var.ptr_level for var in metadata.variables):
+            raise TransformationError(f"@serializable struct '{struct_name}' needs fixed size arithmetic fields.")
+        fields, native_size = layout
+        self.require_support("wire")
+        self.require_support("serializable")
+        header_size = 8
+        schema = ';'.join(f"{field_c_type(var)} {var.name}{var.array or ''}" for var, _, _, _ in fields)
+        schema_hash = fnv1a32(schema.encode())
+
+        serialize = f"size_t {struct_name}_serialize(const {struct_name}_t *self, void *buffer, size_t capacity)"
+        view = f"int {struct_name}_view({struct_name}_view_t *view, const void *buffer, size_t size)"
+        if not self.declare_in_place:
+            self.pre_declarations.append(f"typedef struct {struct_name}_view_s {struct_name}_view_t;\n")
+            self.pre_declarations.append(f"{serialize};\n{view};\n")
+        code = [
+            f"// Schema: {schema}\n",
+            f"#define {struct_name}_SCHEMA_HASH 0x{schema_hash:08x}u\n",
+            f"#define {struct_name}_SERIALIZED_SIZE {header_size + native_size}u\n",
+        ]
+        if self.declare_in_place:
+            code.append(f"typedef struct {struct_name}_view_s {struct_name}_view_t;\n")
+        code.append(f"struct {struct_name}_view_s {{\n    const unsigned char *data;\n}};\n")
+
+        def bits(size: int) -> str:
+            return f"uint{size * 8}_t"
+
+        stores = []
+        for var, offset, size, count in fields:
+            parameters = f"{struct_name}_view_t view, size_t ns_k" if var.array else f"{struct_name}_view_t view"
+            source = f"view.data + {header_size + offset}{f' + ns_k * {size}' if var.array else ''}"
+            c_type = field_c_type(var)
+            if size == 1:
+                load = f"    memcpy(&value, {source}, 1);\n"
+                store = f"memcpy(data + {header_size + offset}{' + ns_k' if var.array else ''}, {'' if var.array else '&'}self->{var.name}{' + ns_k' if var.array else ''}, 1);"
+            else:
+                load = (
+                    f"    {bits(size)} ns_bits;\n"
+                    f"    memcpy(&ns_bits, {source}, {size});\n"
+                    f"    ns_bits = NS_LE{size * 8}(ns_bits);\n"
+                    f"    memcpy(&value, &ns_bits, {size});\n"
+                )
+                element = f"self->{var.name}[ns_k]" if var.array else f"self->{var.name}"
+                target = f"data + {header_size + offset}{f' + ns_k * {size}' if var.array else ''}"
+                store = (f"{{ {bits(size)} ns_bits; memcpy(&ns_bits, &{element}, {size}); "
+                         f"ns_bits = NS_LE{size * 8}(ns_bits); memcpy({target}, &ns_bits, {size}); }}")
+            if var.array:
+                store = f"for (size_t ns_k = 0; ns_k < {count}; ns_k++) {store}"
+            stores.append(f"    {store}\n")
+            code.append(
+                f"static inline {c_type} {struct_name}_view_{var.name}({parameters}) {{\n"
+                f"    {c_type} value;\n{load}    return value;\n}}\n"
+            )
+
+        wire_size = sum(size * count for _, _, size, count in fields)
+        if wire_size == native_size:
+            payload = (
+                f"#if NS_HOST_BIG_ENDIAN\n{''.join(stores)}#else\n"
+                f"    memcpy(data + {header_size}, self, sizeof *self);\n#endif\n"
+            )
+        else:
+            payload = f"    memset(data + {header_size}, 0, {native_size});\n{''.join(stores)}"
+        code.append(
+            f"{serialize} {{\n"
+            f"    // Offsets and sizes follow the LP64 layout, which ILP32 and LLP64 targets do not share\n"
+            f"    _Static_assert(sizeof({struct_name}_t) == {native_size}, \"unexpected {struct_name} layout\");\n"
+            f"    unsigned char *data = (unsigned char *)buffer;\n"
+            f"    if (capacity < {struct_name}_SERIALIZED_SIZE) return 0;\n"
+            f"    uint32_t ns_header[2] = {{ NS_LE32({struct_name}_SCHEMA_HASH), NS_LE32({native_size}u) }};\n"
+            f"    memcpy(data, ns_header, sizeof ns_header);\n"
+            f"{payload}"
+            f"    return {struct_name}_SERIALIZED_SIZE;\n"
+            f"}}\n"
+        )
+        code.append(
+            f"{view} {{\n"
+            f"    uint32_t ns_header[2];\n"
+            f"    if (size < {struct_name}_SERIALIZED_SIZE) return -1;\n"
+            f"    memcpy(ns_header, buffer, sizeof ns_header);\n"
+            f"    if (NS_LE32(ns_header[0]) != {struct_name}_SCHEMA_HASH || NS_LE32(ns_header[1]) != {native_size}u) return -1;\n"
+            f"    view->data = (const unsigned char *)buffer;\n"
+            f"    return 0;\n"
+            f"}}\n"
+        )
+        return ''.join(code)
+
+    def generate_name_lookup(self, signature: str, names: List[str]) -> str:
+        """
+        Emits a function mapping a name to its index in names with a minimal perfect hash.
+
+        A lookup hashes the name twice and does a single memcmp, returning -1 for unknown names.
+
+        Args:
+            signature (str): The function signature, taking `const char *name, size_t length`.
+            names (List[str]): The distinct names in index order.
+
+        Returns:
+            str: The lookup function definition.
+        """
+        self.require_support("perfect_hash")
+        seeds, slots = perfect_hash(names)
+        count = len(names)
+        literals = ', '.join(f'"{names[index]}"' for index in slots)
+        return (
+            f"{signature} {{\n"
+            f"    static const uint32_t seeds[{count}] = {{ {', '.join(f'{seed}u' for seed in seeds)} }};\n"
+            f"    static const char *const names[{count}] = {{ {literals} }};\n"
+            f"    static const uint32_t lengths[{count}] = {{ {', '.join(str(len(names[index])) for index in slots)} }};\n"
+            f"    static const int indexes[{count}] = {{ {', '.join(str(index) for index in slots)} }};\n"
+            f"    uint32_t bucket = (uint32_t)((uint64_t)ns_fnv1a(name, length, 0x811c9dc5u) * {count}u >> 32);\n"
+            f"    uint32_t slot = (uint32_t)((uint64_t)ns_fnv1a(name, length, seeds[bucket]) * {count}u >> 32);\n"
+            f"    if (lengths[slot] != length || memcmp(names[slot], name, length) != 0) return -1;\n"
+            f"    return indexes[slot];\n"
+            f"}}\n"
+        )
+
+    def json_field_kind(self, var: Variable) -> Tuple[str, int]:
+        """
+        Classifies a struct field for JSON as `string`, `bool`, `float`, `double`, `signed` or `unsigned`.
+
+        Args:
+            var (Variable): The field.
+
+        Returns:
+            Tuple[str, int]: The kind and the element size in bytes.
+        """
+        c_type = field_c_type(var)
+        size = C_TYPE_SIZES.get(c_type)
+        if var.ptr_level or size is None:
+            raise TransformationError(f"@json field '{var.name}' needs an arithmetic type, not '{c_type}{'*' * var.ptr_level}'.")
+        if c_type == "char" and var.array:
+            return "string", size
+        if c_type in ("bool", "_Bool"):
+            return "bool", size
+        if c_type in ("float", "double"):
+            return c_type, size
+        unsigned = c_type.startswith(("unsigned", "uint")) or c_type in ("size_t", "uintptr_t")
+        return "unsigned" if unsigned else "signed", size
+
+    def generate_json_codec(self, struct_name: str, metadata: StructMetadata) -> str:
+        """
+        Emits Type_to_json and Type_from_json for a @json struct.
+
+        Encoding writes precomputed keys with memcpy and never checks bounds per field, as the buffer
+        must hold Type_JSON_MAX_SIZE bytes. Decoding reads the text once without building a DOM and
+        finds each key's field with a perfect hash. Unknown keys are skipped and fields missing from
+        the input keep their value.
+
+        Args:
+            struct_name (str): The name of the struct.
+            metadata (StructMetadata): The struct metadata.
+
+        Returns:
+            str: The encoder and decoder definitions.
+        """
+        layout = field_layout(metadata.variables)
+        if not metadata.variables or layout is None:
+            raise TransformationError(f"@json struct '{struct_name}' needs fixed size fields.")
+        self.require_support("json")
+        to_json = f"size_t {struct_name}_to_json(const {struct_name}_t *self, char *buffer, size_t capacity)"
+        from_json = f"int {struct_name}_from_json({struct_name}_t *out, const char *json, size_t length)"
+        if not self.declare_in_place:
+            self.pre_declarations.append(f"{to_json};\n{from_json};\n")
+
+        max_size = 2
+        writes = []
+        reads = []
+        for position, (var, _, size, count) in enumerate(layout[0]):
+            kind, size = self.json_field_kind(var)
+            key = f"{'{' if position == 0 else ','}\\\"{var.name}\\\":"
+            key_length = len(var.name) + 4
+            writes.append(f"    memcpy(p, \"{key}\", {key_length});\n    p += {key_length};\n")
+            max_size += key_length
+            bits = size * 8
+            element = f"self->{var.name}[ns_k]" if var.array else f"self->{var.name}"
+            target = f"out->{var.name}[ns_k]" if var.array else f"out->{var.name}"
+            if kind == "string":
+                writes.append(f"    p = ns_json_write_string(p, self->{var.name}, {count});\n")
+                reads.append([f"if (!ns_json_read_string(&reader, out->{var.name}, {count})) return -1;"])
+                max_size += 2 + 6 * count
+                continue
+            if kind == "bool":
+                write, width = f"p = ns_json_write_bool(p, {element});", 5
+                read = ["int value;", "if (!ns_json_read_bool(&reader, &value)) return -1;", f"{target} = value;"]
+            elif kind in ("float", "double"):
+                write, width = f"p = ns_json_write_double(p, {element}, {9 if kind == 'float' else 17});", 32
+                read = ["double value;", "if (!ns_json_read_double(&reader, &value)) return -1;", f"{target} = ({field_c_type(var)})value;"]
+            elif kind == "unsigned":
+                write, width = f"p = ns_json_write_u64(p, {element});", len(str(2 ** bits - 1))
+                read = ["uint64_t value;", f"if (!ns_json_read_u64(&reader, {2 ** bits - 1}ULL, &value)) return -1;",
+                        f"{target} = ({field_c_type(var)})value;"]
+            else:
+                write, width = f"p = ns_json_write_i64(p, {element});", len(str(-2 ** (bits - 1)))
+                read = ["int64_t value;", f"if (!ns_json_read_i64(&reader, -{2 ** (bits - 1) - 1}LL - 1, {2 ** (bits - 1) - 1}LL, &value)) return -1;",
+                        f"{target} = ({field_c_type(var)})value;"]
+            if var.array:
+                writes.append(
+                    f"    *p++ = '[';\n"
+                    f"    for (size_t ns_k = 0; ns_k < {count}; ns_k++) {{\n"
+                    f"        if (ns_k) *p++ = ',';\n"
+                    f"        {write}\n"
+                    f"    }}\n"
+                    f"    *p++ = ']';\n"
+                )
+                reads.append(
+                    ["if (!ns_json_expect(&reader, '[')) return -1;",
+                     f"for (size_t ns_k = 0; ns_k < {count}; ns_k++) {{",
+                     "    if (ns_k && !ns_json_expect(&reader, ',')) return -1;"]
+                    + [f"    {statement}" for statement in read]
+                    + ["}", "if (!ns_json_expect(&reader, ']')) return -1;"]
+                )
+                max_size += 2 + count * (width + 1)
+            else:
+                writes.append(f"    {write}\n")
+                reads.append(read)
+                max_size += width
+
+        lookup = f"static int {struct_name}_json_field(const char *name, size_t length)"
+        cases = ''.join(
+            f"        case {index}: {{\n{''.join(f'            {statement}{chr(10)}' for statement in read)}            break;\n        }}\n"
+            for index, read in enumerate(reads)
+        )
+        return (
+            f"#define {struct_name}_JSON_MAX_SIZE {max_size + 1}u\n"
+            f"{self.generate_name_lookup(lookup, [var.name for var in metadata.variables])}"
+            f"{to_json} {{\n"
+            f"    if (capacity < {struct_name}_JSON_MAX_SIZE) return 0;\n"
+            f"    char *p = buffer;\n"
+            f"{''.join(writes)}"
+            f"    *p++ = '}}';\n"
+            f"    *p = '\\0';\n"
+            f"    return (size_t)(p - buffer);\n"
+            f"}}\n"
+            f"{from_json} {{\n"
+            f"    ns_json_reader_t reader = {{ json, json + length }};\n"
+            f"    if (!ns_json_expect(&reader, '{{')) return -1;\n"
+            f"    int more = !ns_json_expect(&reader, '}}');\n"
+            f"    while (more) {{\n"
+            f"        const char *key;\n"
+            f"        size_t key_length;\n"
+            f"        if (!ns_json_read_key(&reader, &key, &key_length) || !ns_json_expect(&reader, ':')) return -1;\n"
+            f"        switch ({struct_name}_json_field(key, key_length)) {{\n"
+            f"{cases}"
+            f"        default:\n"
+            f"            if (!ns_json_skip(&reader, 0)) return -1;\n"
+            f"        }}\n"
+            f"        more = ns_json_expect(&reader, ',');\n"
+            f"        if (!more && !ns_json_expect(&reader, '}}')) return -1;\n"
+            f"    }}\n"
+            f"    ns_json_space(&reader);\n"
+            f"    return reader.at == reader.end ? 0 : -1;\n"
+            f"}}\n"
+        )
+
+    def reflects(self, struct_name: str) -> bool:
+        """Whether a struct gets a field descriptor table, through @reflect or a use of Type@fields."""
+        metadata = self.struct_metadata[struct_name]
+        if "reflect" in metadata.attributes:
+            return True
+        accessors = [name for name in ("fields", "field_count") if name not in metadata.globals]
+        return bool(accessors) and re.search(rf"\b{struct_name}@(?:{'|'.join(accessors)})\b", self.original_code) is not None
+
+    def type_code(self, var: Variable) -> str:
+        """
+        Returns the ns_type_code_t of a field's element type; pointers are described by their pointee.
+
+        Args:
+            var (Variable): The field.
+
+        Returns:
+            str: The type code constant.
+        """
+        c_type = field_c_type(var)
+        if c_type.endswith("_t") and c_type[:-2] in self.struct_metadata:
+            return "NS_TYPE_STRUCT"
+        if c_type in ("bool", "_Bool"):
+            return "NS_TYPE_BOOL"
+        if c_type in ("char", "signed char", "unsigned char"):
+            return "NS_TYPE_CHAR"
+        if c_type in ("float", "double"):
+            return "NS_TYPE_FLOAT"
+        if c_type not in C_TYPE_SIZES:
+            return "NS_TYPE_OTHER"
+        unsigned = c_type.startswith(("unsigned", "uint")) or c_type in ("size_t", "uintptr_t")
+        return "NS_TYPE_UINT" if unsigned else "NS_TYPE_INT"
+
+    def generate_reflection(self, struct_name: str, metadata: StructMetadata) -> str:
+        """
+        Emits the Type_fields descriptor table, one ns_field_t per field in declaration order.
+
+        Args:
+            struct_name (str): The name of the struct.
+            metadata (StructMetadata): The struct metadata.
+
+        Returns:
+            str: The field count and descriptor table definitions.
+        """
+        self.require_support("reflect")
+        count = len(metadata.variables)
+        declaration = f"static const ns_field_t {struct_name}_fields[{max(count, 1)}]"
+        if not self.declare_in_place:
+            self.pre_declarations.append(f"{declaration};\n")
+        rows = []
+        for var in metadata.variables:
+            member = f"(({struct_name}_t *)0)->{var.name}"
+            element_count = f"sizeof({member}) / sizeof({member}[0])" if var.array else "1"
+            type_name = f"{var.keywords}{var.type}{' ' + '*' * var.ptr_level if var.ptr_level else ''}"
+            rows.append(
+                f"    {{ \"{var.name}\", \"{type_name}\", offsetof({struct_name}_t, {var.name}), sizeof({member}), "
+                f"{element_count}, {self.type_code(var)}, {var.ptr_level} }},\n"
+            )
+        if not rows:
+            rows.append("    { 0 },\n")
+        return f"#define {struct_name}_FIELD_COUNT {count}\n{declaration} = {{\n{''.join(rows)}}};\n"
+
+    def generate_name_lookups(self, struct_name: str, metadata: StructMetadata) -> str:
+        """
+        Emits Type_find_method and Type_find_field, which map a name to its declaration index in O(1).
+
+        The indexes are named by the Type_METHOD_<name> and Type_FIELD_<name> enumerators, so a string
+        keyed dispatch is one lookup and a switch.
+
+        Args:
+            struct_name (str): The name of the struct.
+            metadata (StructMetadata): The struct metadata.
+
+        Returns:
+            str: The index enums and lookup function definitions.
+        """
+        code = []
+        for kind, names in (("method", list(metadata.methods)), ("field", [var.name for var in metadata.variables])):
+            signature = f"int {struct_name}_find_{kind}(const char *name, size_t length)"
+            if not self.declare_in_place:
+                self.pre_declarations.append(f"{signature};\n")
+            if names:
+                enumerators = ''.join(f"    {struct_name}_{kind.upper()}_{name},\n" for name in names)
+                code.append(f"enum {struct_name}_{kind}_index_e {{\n{enumerators}}};\n")
+                code.append(self.generate_name_lookup(signature, names))
+            else:
+                code.append(f"{signature} {{\n    (void)name;\n    (void)length;\n    return -1;\n}}\n")
+        return ''.join(code)
+
+    def generate_hash_functions(self, struct_name: str, metadata: StructMetadata) -> str:
+        """
+        Emits Type_hash and Type_eq for a @hashable struct.
+
+        Both only look at the bytes of fields, never at padding. Type_hash mixes them eight bytes at
+        a time, one run of adjacent fields after the other. Type_eq is a single memcmp when the
+        layout has no padding and a memcmp per run otherwise. Fields compare bitwise, so the two
+        agree on floating point fields: -0.0 differs from 0.0 and a NaN equals itself.
+
+        Args:
+            struct_name (str): The name of the struct.
+            metadata (StructMetadata): The struct metadata.
+
+        Returns:
+            str: The hash and equality function definitions.
+        """
+        layout = field_layout(metadata.variables)
+        if not metadata.variables or layout is None:
+            raise TransformationError(f"@hashable struct '{struct_name}' needs fixed size fields.")
+        fields, native_size = layout
+        self.require_support("hashable")
+        runs: List[List[int]] = []
+        for _, offset, size, count in fields:
+            if runs and runs[-1][1] == offset:
+                runs[-1][1] = offset + size * count
+            else:
+                runs.append([offset, offset + size * count])
+
+        hash_signature = f"uint64_t {struct_name}_hash(const {struct_name}_t *self)"
+        eq_signature = f"int {struct_name}_eq(const {struct_name}_t *a, const {struct_name}_t *b)"
+        if not self.declare_in_place:
+            self.pre_declarations.append(f"{hash_signature};\n{eq_signature};\n")
+        layout_check = f"    _Static_assert(sizeof({struct_name}_t) == {native_size}, \"unexpected {struct_name} layout\");\n"
+
+        words = []
+        for start, end in runs:
+            for offset in range(start, end, 8):
+                length = min(8, end - offset)
+                if length < 8:
+                    words.append(f"    word = 0;\n")
+                words.append(f"    memcpy(&word, bytes + {offset}, {length});\n    hash = ns_hash_mix(hash, word);\n")
+        if len(runs) == 1 and runs[0] == [0, native_size]:
+            compare = f"    return memcmp(a, b, sizeof *a) == 0;\n"
+        else:
+            checks = " &&\n           ".join(
+                f"memcmp((const unsigned char *)a + {start}, (const unsigned char *)b + {start}, {end - start}) == 0"
+                for start, end in runs
+            )
+            compare = f"    return {checks};\n"
+        return (
+            f"{hash_signature} {{\n"
+            f"{layout_check}"
+            f"    const unsigned char *bytes = (const unsigned char *)self;\n"
+            f"    uint64_t hash = 0x9e3779b97f4a7c15u;\n"
+            f"    uint64_t word;\n"
+            f"{''.join(words)}"
+            f"    return ns_hash_finish(hash);\n"
+            f"}}\n"
+            f"{eq_signature} {{\n"
+            f"{layout_check}"
+            f"{compare}"
+            f"}}\n"
+        )
+
     def generate_transformed_method(self, struct_name: str, method: Method) -> str:
         """
         Generates the standalone function equivalent of a struct method.
@@ -615,29 +2585,454 @@ class CodeGenerator:
             for arg in method.arguments
         )
         if method.has_self:
-            if not self.declare_in_place:
-                transformed_function = (
-                    f"{method.return_type} {'*' * method.ptr_level}{struct_name}_{method.name}({struct_name}_t *self{arg_string}{transformed_args});\n")
-                self.pre_declarations.append(transformed_function)
+            parameters = f"{struct_name}_t *self{arg_string}{transformed_args}"
+        else:
+            parameters = transformed_args
+        signature = f"{method.return_type} {'*' * method.ptr_level}{struct_name}_{method.name}({parameters})"
+        prologue, epilogue = self.method_instrumentation(struct_name, method)
+        if "export" in method.attributes:
+            self.exported_methods.append(f"{struct_name}_{method.name}")
+        else:
+            self.internal_symbols.append(f"{struct_name}_{method.name}")
+        prologue_code = ''.join(f"    {statement}\n" for statement in prologue)
+        epilogue_code = ''.join(f"    {statement}\n" for statement in epilogue)
+        body = self.lower_tail_calls(struct_name, method) if "tailcall" in method.attributes else method.body
+
+        if not self.declare_in_place:
+            self.pre_declarations.append(f"{self.method_decorations(struct_name, method, False)}{signature};\n")
+        if epilogue_code:
+            # The original body moves into an inline function so every return passes through the epilogue
+            return_type = f"{method.return_type} {'*' * method.ptr_level}".strip()
+            body_name = f"{struct_name}_{method.name}__body"
+            forwarded = ["self"] if method.has_self else []
+            forwarded.extend(split_argument(arg)[1] for arg in method.arguments)
+            call = f"{body_name}({', '.join(forwarded)})"
+            if return_type == "void":
+                invoke = f"    {call};\n"
+                finish = ""
+            else:
+                invoke = f"    {return_type} ns_result = {call};\n"
+                finish = "    return ns_result;\n"
             transformed_function = (
-                f"{method.return_type} {'*' * method.ptr_level}{struct_name}_{method.name}({struct_name}_t *self{arg_string}{transformed_args}) {{\n"
-                f"    {method.body}\n"
+                f"static inline {return_type} {body_name}({parameters}) {{\n"
+                f"    {body}\n"
+                f"}}\n"
+                f"{self.method_decorations(struct_name, method, True)}{signature} {{\n"
+                f"{prologue_code}"
+                f"{invoke}"
+                f"{epilogue_code}"
+                f"{finish}"
                 f"}}\n"
             )
         else:
-            if not self.declare_in_place:
-                transformed_function = (
-                    f"{method.return_type} {'*' * method.ptr_level}{struct_name}_{method.name}({transformed_args});\n")
-                self.pre_declarations.append(transformed_function)
             transformed_function = (
-                f"{method.return_type} {'*' * method.ptr_level}{struct_name}_{method.name}({transformed_args}) {{\n"
-                f"    {method.body}\n"
+                f"{self.method_decorations(struct_name, method, True)}{signature} {{\n"
+                f"{prologue_code}"
+                f"    {body}\n"
                 f"}}\n"
             )
         logger.debug(f"Generated transformed method:\n{transformed_function}")
 
         return "\n".join([line.strip() for line in method.comments.splitlines()]) + "\n" + transformed_function
 
+    def specialization_arguments(self, method: Method, args: List[str], self_included: bool) -> Dict[str, str]:
+        """Maps the @specialize parameters of a method to the literal arguments a call passes for them."""
+        names = [split_argument(arg)[1] for arg in method.arguments]
+        if self_included:
+            args = args[1:]
+        if len(args) != len(names):
+            return {}
+        specialized = [name.strip() for name in method.attributes.get("specialize", [])]
+        # `- 1` and `-1` are one constant, so they share one clone
+        return {name: re.sub(r"^-\s+", "-", arg) for name, arg in zip(names, args)
+                if name in specialized and re.match(self.SPECIALIZE_LITERAL_PATTERN, arg)}
+
+    def collect_specializations(self):
+        """
+        Finds the distinct literal values passed to the @specialize parameters of each method at @ call sites.
+        The receiver type of obj@name( is not known yet, so a call counts for every specialized method of that name.
+        """
+        candidates: Dict[str, List[Tuple[str, Method]]] = {}
+        for struct_name, metadata in self.struct_metadata.items():
+            for method in metadata.methods.values():
+                if method.attributes.get("specialize"):
+                    candidates.setdefault(method.name, []).append((struct_name, method))
+        if not candidates:
+            return
+        # Calls in comments and strings are not call sites; the blanked copy keeps indices aligned
+        for match in re.finditer(r"\b(\w+)@(\w+)\s*\(", blank_comments_and_literals(self.original_code)):
+            if match.group(2) not in candidates:
+                continue
+            close_index = find_closing_bracket(self.original_code, match.end() - 1)
+            args = split_top_level(self.original_code[match.end():close_index], ',') if close_index > 0 else None
+            if args is None:
+                continue
+            for struct_name, method in candidates[match.group(2)]:
+                if match.group(1) != struct_name and match.group(1) in self.struct_metadata:
+                    continue
+                self_included = method.has_self and match.group(1) == struct_name
+                constants = tuple(self.specialization_arguments(method, args, self_included).items())
+                known = self.specializations.setdefault((struct_name, method.name), [])
+                if constants and constants not in known:
+                    known.append(constants)
+                    logger.debug(f"Specializing {struct_name}@{method.name} for {constants}")
+
+    def specialization_name(self, method_name: str, constants: Tuple[Tuple[str, str], ...]) -> str:
+        """Names the clone of a method for a set of constant parameters, e.g. scale__mode_1__size_64."""
+        suffix = ''.join(f"__{name}_{re.sub(r'[^0-9A-Za-z]', '_', value.replace('-', 'neg'))}"
+                         for name, value in constants)
+        return f"{method_name}{suffix}"
+
+    def specialized_method(self, method: Method, constants: Tuple[Tuple[str, str], ...]) -> Method:
+        """
+        Clones a method for constant values of some of its parameters. The parameters become locals
+        initialized to the constants, const unless the body assigns them, so branches on them fold away.
+
+        Args:
+            method (Method): The @specialize method.
+            constants (Tuple[Tuple[str, str], ...]): The specialized parameter names and literal values.
+
+        Returns:
+            Method: The clone, without the specialized parameters.
+        """
+        values = dict(constants)
+        arguments = []
+        locals_code = []
+        for arg in method.arguments:
+            arg_type, name = split_argument(arg)
+            if name not in values:
+                arguments.append(arg)
+                continue
+            assigned = re.search(rf"(?:\b{name}\s*(?:[-+*/%&|^]|<<|>>)?=(?!=)|\+\+\s*{name}\b|--\s*{name}\b|\b{name}\s*(?:\+\+|--))", method.body)
+            qualifier = "" if assigned or arg_type.startswith("const ") else "const "
+            locals_code.append(f"{qualifier}{arg_type} {name} = {values[name]};\n    ")
+        attributes = {key: value for key, value in method.attributes.items() if key not in ("specialize", "export", "bench")}
+        return replace(method, name=self.specialization_name(method.name, constants), arguments=arguments,
+                       body="".join(locals_code) + method.body, attributes=attributes, comments="")
+
+    def specialize_call(self, struct_name: str, method: Method, args: str, self_included: bool) -> Tuple[str, str]:
+        """
+        Redirects a call of a @specialize method to the clone matching its literal arguments.
+
+        Args:
+            struct_name (str): The name of the struct.
+            method (Method): The called method.
+            args (str): The call arguments.
+            self_included (bool): Whether the arguments start with an explicit self.
+
+        Returns:
+            Tuple[str, str]: The function to call and the remaining arguments.
+        """
+        arg_list = split_top_level(args, ',') or []
+        constants = tuple(self.specialization_arguments(method, arg_list, self_included).items())
+        if constants not in self.specializations.get((struct_name, method.name), []):
+            return f"{struct_name}_{method.name}", args
+        offset = 1 if self_included else 0
+        names = [split_argument(arg)[1] for arg in method.arguments]
+        kept = arg_list[:offset] + [arg for name, arg in zip(names, arg_list[offset:]) if name not in dict(constants)]
+        return f"{struct_name}_{self.specialization_name(method.name, constants)}", ', '.join(kept)
+
+    def parameter_types(self, struct_name: str, method: Method) -> List[str]:
+        """Lists the C types of a method's parameters, self included."""
+        types = [f"{struct_name}_t *"] if method.has_self else []
+        types.extend(re.sub(r"\s+", " ", split_argument(arg)[0]) for arg in method.arguments)
+        return types
+
+    def lower_tail_calls(self, struct_name: str, method: Method) -> str:
+        """
+        Rewrites the tail calls of a @tailcall method. `return self@name(...)` and `return Type@name(...)`
+        calls of the method itself store their arguments and jump back to the top of the body, where the
+        parameters are reassigned at function scope so locals shadowing them are left alone. Other tail
+        calls to methods with an identical signature get NS_MUSTTAIL unless the frame may escape.
+
+        Args:
+            struct_name (str): The name of the struct.
+            method (Method): The method metadata.
+
+        Returns:
+            str: The method body with its tail calls lowered.
+        """
+        body = method.body
+        signature = (method.return_type, method.ptr_level, self.parameter_types(struct_name, method))
+        parameters = (["self"] if method.has_self else []) + [split_argument(arg)[1] for arg in method.arguments]
+        types = self.parameter_types(struct_name, method)
+        # Parameters that are const themselves cannot be reassigned, so self calls stay calls
+        read_only = [param for param, param_type in zip(parameters, types)
+                     if re.search(r"\bconst\b", param_type.rsplit('*', 1)[-1])]
+        if read_only:
+            logger.warning(f"@tailcall {struct_name}@{method.name} has const parameters ({', '.join(read_only)}), "
+                           f"so its self tail calls are not turned into a loop.")
+        # A pointer into this frame, taken with & or decayed from a local array, dangles after musttail
+        blanked = blank_comments_and_literals(body)
+        frame_escapes = bool(re.search(r"(?<!&)&(?!&)", blanked)
+                             or re.search(r"\b(?!return\b)[A-Za-z_]\w*[\s*]+[A-Za-z_]\w*\s*\[", blanked))
+        pieces = []
+        last = 0
+        looped = False
+        for match in re.finditer(r"\breturn\s+(\w+)@(\w+)\s*\(", body):
+            if match.start() < last:
+                continue
+            close_index = find_closing_bracket(body, match.end() - 1)
+            end = re.match(r"\s*;", body[close_index + 1:]) if close_index > 0 else None
+            args = split_top_level(body[match.end():close_index], ',') if end else None
+            if args is None:
+                continue
+            receiver, callee_name = match.group(1), match.group(2)
+            if receiver == "self" and method.has_self:
+                callee_struct = struct_name
+                args = ["self"] + args
+            elif receiver in self.struct_metadata:
+                callee_struct = receiver
+            else:
+                continue
+            callee = self.struct_metadata[callee_struct].methods.get(callee_name)
+            if not callee:
+                continue
+            statement_end = close_index + 1 + end.end()
+
+            if callee is method and len(args) == len(parameters) and not read_only:
+                line_start = body.rfind('\n', 0, match.start()) + 1
+                indent = re.match(r"\s*", body[line_start:]).group(0)
+                # Every argument is evaluated before any parameter changes, as in a real call
+                statements = [f"ns_tail_{param} = {arg};" for param, arg in zip(parameters, args)]
+                statements.append("goto ns_tailcall;")
+                lowered = f"{{\n" + "".join(f"{indent}    {statement}\n" for statement in statements) + f"{indent}}}"
+                pieces.append(body[last:match.start()])
+                pieces.append(lowered)
+                last = statement_end
+                looped = True
+            elif (callee.return_type, callee.ptr_level, self.parameter_types(callee_struct, callee)) == signature \
+                    and not frame_escapes and not re.search(r"\)\s*\{", ''.join(args)):
+                # musttail callers may not pass pointers into their own frame, compound literals included
+                self.require_support("musttail")
+                pieces.append(body[last:match.start()])
+                # self@ calls are spelled Type@name(self, ...), which call refactoring resolves inside methods
+                pieces.append(f"NS_MUSTTAIL return {callee_struct}@{callee_name}({', '.join(args)});")
+                last = statement_end
+        pieces.append(body[last:])
+        body = "".join(pieces)
+        if looped:
+            # The parameters are outside every block of the body, so no local can shadow them here
+            temporaries = "".join(f"{param_type.rstrip()}{'' if param_type.endswith('*') else ' '}ns_tail_{param};\n    "
+                                  for param, param_type in zip(parameters, types))
+            assignments = "".join(f"        {param} = ns_tail_{param};\n" for param in parameters)
+            body = f"{temporaries}if (0) {{\nns_tailcall:\n{assignments}    }}\n    {body}"
+        else:
+            logger.debug(f"No self recursive tail call in {struct_name}@{method.name}")
+        return body
+
+    def method_instrumentation(self, struct_name: str, method: Method) -> Tuple[List[str], List[str]]:
+        """
+        Builds the statements run on entry to and exit from a method for the enabled instrumentation modes.
+
+        Args:
+            struct_name (str): The name of the struct.
+            method (Method): The method metadata.
+
+        Returns:
+            Tuple[List[str], List[str]]: The prologue and epilogue statements. A non empty epilogue
+            makes the method a wrapper around its original body.
+        """
+        qualified_name = f"{struct_name}@{method.name}"
+        modes = set()
+        if any(fnmatch.fnmatchcase(qualified_name, glob) for glob in self.instrument_filter):
+            modes.update(self.instrument)
+        if "perfcount" in method.attributes:
+            modes.add("perf")
+        if not modes:
+            return [], []
+        method_id = len(self.instrumented_methods)
+        self.instrumented_methods.append(qualified_name)
+        prologue = []
+        epilogue = []
+        # Call counts cover every method given an id so profiles never see a counted method as unused
+        if "calls" in self.instrument:
+            self.require_support("call_counts")
+            prologue.append(f"NS_COUNT_CALL({method_id});")
+        if "latency" in modes:
+            self.require_support("latency")
+            prologue.append("uint64_t ns_latency_start = NS_LATENCY_NOW();")
+            epilogue.append(f"ns_latency_record({method_id}, NS_LATENCY_NOW() - ns_latency_start);")
+        if "trace" in modes:
+            self.require_support("trace")
+            prologue.append(f"ns_trace_emit({method_id}, 'B');")
+            epilogue.append(f"ns_trace_emit({method_id}, 'E');")
+        if "perf" in modes:
+            self.require_support("perfcount")
+            prologue.append("ns_perf_sample ns_perf_start;")
+            prologue.append("ns_perf_read(&ns_perf_start);")
+            epilogue.append(f"ns_perf_record({method_id}, &ns_perf_start);")
+        return prologue, epilogue
+
+    def instrumented_method_table(self) -> str:
+        """Builds the table naming instrumented methods by id, which the instrumentation runtimes index."""
+        names = ''.join(f'    "{name}",\n' for name in self.instrumented_methods)
+        return (
+            f"#define NS_METHOD_COUNT {len(self.instrumented_methods)}\n"
+            f"static const char *const ns_method_names[NS_METHOD_COUNT] = {{\n{names}}};\n"
+        )
+
+    def apply_profile(self):
+        """
+        Marks methods from a call count profile: the methods taking the bulk of all calls become hot
+        and methods that were never called become cold. Explicit @hot/@cold attributes win.
+        """
+        methods = {}
+        for struct_name, metadata in self.struct_metadata.items():
+            for method in metadata.methods.values():
+                methods[f"{struct_name}@{method.name}"] = method
+        profiled = sorted(
+            ((count, name) for name, count in self.profile.items() if name in methods),
+            reverse=True
+        )
+        total = sum(count for count, _ in profiled)
+        covered = 0
+        for count, name in profiled:
+            method = methods[name]
+            if "hot" in method.attributes or "cold" in method.attributes:
+                continue
+            if count == 0:
+                method.attributes["cold"] = []
+                logger.debug(f"Profile marks {name} cold")
+            elif covered < total * self.PROFILE_HOT_FRACTION:
+                method.attributes["hot"] = []
+                logger.debug(f"Profile marks {name} hot with {count} calls")
+            covered += count
+
+    def eliminate_dead_code(self):
+        """
+        Finds the methods and globals reachable from file scope code (main and the other free functions,
+        which are emitted unchanged), @export and --entry methods and the @bench methods of a --bench build, following
+        Type@name uses and @name( calls. Unreachable ones are dropped from the metadata, or recorded to be
+        emitted static and unused.
+        """
+        # Names in comments and string literals are not uses
+        root_code = blank_comments_and_literals(self.original_code)
+        for match in reversed(list(re.finditer(rf"^{CodeParser.STRUCT_HEADER_PATTERN}", root_code, re.MULTILINE))):
+            if match.group(1) not in self.struct_metadata:
+                continue
+            close_index = find_closing_bracket(root_code, match.end() - 1)
+            if close_index > 0:
+                root_code = root_code[:match.start()] + root_code[close_index + 1:]
+
+        def references(text: str) -> List[str]:
+            found = []
+            for match in re.finditer(r"\b(\w+)@(\w+)", text):
+                metadata = self.struct_metadata.get(match.group(1))
+                if metadata and (match.group(2) in metadata.methods or match.group(2) in metadata.globals):
+                    found.append(match.group(0))
+            # The receiver type of obj@name( is only known during call refactoring, so keep every candidate
+            for match in re.finditer(r"@(\w+)\s*\(", text):
+                found.extend(f"{struct_name}@{match.group(1)}" for struct_name, metadata in self.struct_metadata.items()
+                             if match.group(1) in metadata.methods)
+            return found
+
+        pending = references(root_code)
+        for entry in self.entries:
+            struct_name, _, method_name = entry.partition('@')
+            if method_name not in self.struct_metadata.get(struct_name, StructMetadata()).methods:
+                logger.error(f"Unknown entry point '{entry}'.")
+                continue
+            pending.append(entry)
+        pending.extend(f"{struct_name}@{method.name}" for struct_name, metadata in self.struct_metadata.items()
+                       for method in metadata.methods.values() if "export" in method.attributes)
+        if self.bench:
+            pending.extend(f"{struct_name}@{method.name}" for struct_name, metadata in self.struct_metadata.items()
+                           for method in metadata.methods.values() if "bench" in method.attributes)
+
+        reachable = set()
+        while pending:
+            name = pending.pop()
+            if name in reachable:
+                continue
+            reachable.add(name)
+            struct_name, _, member = name.partition('@')
+            method = self.struct_metadata[struct_name].methods.get(member)
+            if method:
+                pending.extend(references(blank_comments_and_literals(method.body)))
+
+        for struct_name, metadata in self.struct_metadata.items():
+            for kind, members, dead in (("method", metadata.methods, self.dead_methods),
+                                        ("global", metadata.globals, self.dead_globals)):
+                for member in list(members):
+                    qualified_name = f"{struct_name}@{member}"
+                    if qualified_name in reachable:
+                        continue
+                    logger.debug(f"Unreachable {kind} {qualified_name}")
+                    if self.dead_code == "drop":
+                        del members[member]
+                    else:
+                        dead.add(qualified_name)
+
+    def method_decorations(self, struct_name: str, method: Method, definition: bool) -> str:
+        """
+        Lowers method attributes to the pragmas and C attributes placed before its declaration and definition.
+
+        Args:
+            struct_name (str): The name of the struct.
+            method (Method): The method metadata.
+            definition (bool): Whether the decorations are for the definition rather than a pre declaration.
+
+        Returns:
+            str: The decoration lines, each terminated by a newline.
+        """
+        decorations = []
+        # linear(self) needs the complete struct type, which pre declarations come before
+        if "simd" in method.attributes and definition:
+            self.require_support("declare_simd")
+            clauses = method.attributes["simd"] or self.infer_simd_clauses(method)
+            decorations.append(f"NS_DECLARE_SIMD({' '.join(clauses)})")
+        if "hot" in method.attributes:
+            self.require_support("hot_cold")
+            decorations.append("NS_HOT")
+        if "cold" in method.attributes:
+            self.require_support("hot_cold")
+            decorations.append("NS_COLD")
+        if "multiversion" in method.attributes:
+            self.require_support("target_clones")
+            targets = [target.strip('"') for target in method.attributes["multiversion"]]
+            if "default" not in targets:
+                targets.insert(0, "default")
+            quoted_targets = ', '.join(f'"{target}"' for target in targets)
+            decorations.append(f"NS_TARGET_CLONES({quoted_targets})")
+        if f"{struct_name}@{method.name}" in self.dead_methods:
+            self.require_support("dead_code")
+            decorations.append("NS_DEAD_CODE")
+        elif "export" in method.attributes:
+            self.require_support("export")
+            decorations.append("NS_EXPORT")
+        elif self.visibility != "default":
+            self.require_support(f"internal_{self.visibility}")
+            decorations.append("NS_INTERNAL")
+        return "".join(f"{decoration}\n" for decoration in decorations)
+
+    def infer_simd_clauses(self, method: Method) -> List[str]:
+        """
+        Infers `declare simd` clauses for a method called once per element.
+        Self walks consecutive elements, index-like integers step by one and other pointers are shared by all lanes.
+
+        Args:
+            method (Method): The method metadata.
+
+        Returns:
+            List[str]: The uniform/linear clauses, ending with notinbranch.
+        """
+        linear = ["self"] if method.has_self else []
+        uniform = []
+        for arg in method.arguments:
+            arg_type, arg_name = split_argument(arg)
+            if '*' in arg_type or '[' in arg_name:
+                uniform.append(arg_name.split('[')[0])
+            elif re.fullmatch(self.SIMD_INDEX_NAME_PATTERN, arg_name) and re.search(self.SIMD_INDEX_TYPE_PATTERN, arg_type):
+                linear.append(arg_name)
+        clauses = []
+        if uniform:
+            clauses.append(f"uniform({', '.join(uniform)})")
+        if linear:
+            clauses.append(f"linear({', '.join(linear)})")
+        clauses.append("notinbranch")
+        return clauses
+
     def refactor_method_calls_with_scope(self, code: str) -> str:
         """
         Refactors method calls using the @ syntax to standard C function calls with scope-aware replacements.
@@ -711,8 +3106,16 @@ class CodeGenerator:
 
                 method_meta = self.struct_metadata[obj_type].methods[method_name]
 
+                if "constexpr" in method_meta.attributes:
+                    folded = self.fold_constexpr_call(obj_type, method_meta, args)
+                    if folded is not None:
+                        return folded
+
                 # Determine transformed function name
                 transformed_function_name = f"{obj_type}_{method_name}"
+                if (obj_type, method_name) in self.specializations:
+                    transformed_function_name, args = self.specialize_call(
+                        obj_type, method_meta, args, method_meta.has_self and is_type)
 
                 # Build transformed arguments
                 if method_meta.has_self and not is_type:
@@ -733,6 +3136,56 @@ class CodeGenerator:
                 logger.debug(f"Transformed method call: {transformed_call}")
                 return transformed_call
 
+            # Lower arr[lo..hi]@method(args); into a counted loop over the elements
+            def replace_broadcast(match: re.Match) -> str:
+                indent = match.group(1)
+                array_name = match.group(2)
+                low = match.group(3)
+                high = match.group(4)
+                method_name = match.group(5)
+                args = match.group(6).strip()
+
+                logger.debug(f"Refactoring broadcast call: {match.group(0).strip()}")
+
+                variable = self.resolve_variable(array_name, symbol_table_stack)
+                if not variable:
+                    error_msg = f"Unable to determine type for '{array_name}' in broadcast call '{match.group(0).strip()}'."
+                    logger.error(error_msg)
+                    raise TransformationError(error_msg)
+
+                obj_type = variable.type.replace('*', '').strip()
+                if obj_type.endswith("_t") and obj_type[:-2] in self.struct_metadata:
+                    obj_type = obj_type[:-2]
+                if obj_type not in self.struct_metadata or method_name not in self.struct_metadata[obj_type].methods:
+                    error_msg = f"Method '{method_name}' not found in type '{obj_type}' for broadcast over '{array_name}'."
+                    logger.error(error_msg)
+                    raise TransformationError(error_msg)
+
+                method_meta = self.struct_metadata[obj_type].methods[method_name]
+                if not method_meta.has_self:
+                    error_msg = f"Broadcast over '{array_name}' needs '{obj_type}@{method_name}' to take self."
+                    logger.error(error_msg)
+                    raise TransformationError(error_msg)
+
+                # Elements of an array keep the declared pointer depth, elements behind a pointer lose one
+                element_ptr_level = variable.ptr_level if variable.array else variable.ptr_level - 1
+                index = f"ns_i{self.broadcast_count}"
+                self.broadcast_count += 1
+                element = f"{array_name}[{index}]"
+                if element_ptr_level <= 0:
+                    receiver = f"&{element}"
+                else:
+                    receiver = f"{'*' * (element_ptr_level - 1)}{element}"
+                call_args = f"{receiver}, {args}" if args else receiver
+
+                self.require_support("stddef")
+                # A signed index keeps an empty range such as [0..n-1] with n == 0 empty instead of wrapping
+                loop = f"for (ptrdiff_t {index} = ({low}); {index} < (ptrdiff_t)({high}); {index}++) {obj_type}_{method_name}({call_args});"
+                # Pure methods only touch their own element, so iterations are independent
+                if "pure" in method_meta.attributes or "simd" in method_meta.attributes:
+                    self.require_support("simd_loop")
+                    loop = f"NS_SIMD_LOOP\n{indent}{loop}"
+                return f"{indent}{loop}"
 
             # Handle variable declarations
             var_decl_match = re.match(CodeParser.DECLARATION_PATTERN, stripped_line)
@@ -758,7 +3211,8 @@ class CodeGenerator:
 
             # Replace all method calls in the current line
             try:
-                transformed_line = re.sub(self.METHOD_CALL_PATTERN, replace_call, line)
+                transformed_line = re.sub(self.BROADCAST_CALL_PATTERN, replace_broadcast, line)
+                transformed_line = re.sub(self.METHOD_CALL_PATTERN, replace_call, transformed_line)
                 transformed_lines.append(transformed_line)
             except TransformationError as e:
                 logger.error(f"Error transforming line: {line}\n{e}")
@@ -768,6 +3222,22 @@ class CodeGenerator:
         logger.info("Method calls refactored successfully with scope awareness")
         return transformed_code
 
+    def resolve_variable(self, var_name: str, symbol_table_stack: List[Dict[str, Variable]]) -> Optional[Variable]:
+        """
+        Finds the innermost declaration of a variable in the symbol table stack.
+
+        Args:
+            var_name (str): The name of the variable.
+            symbol_table_stack (List[Dict[str, Variable]]): The stack of symbol tables representing scopes.
+
+        Returns:
+            Optional[Variable]: The declared variable, or None when it is not in scope.
+        """
+        for symbol_table in reversed(symbol_table_stack):
+            if var_name in symbol_table:
+                return symbol_table[var_name]
+        return None
+
     def resolve_type(self, var_name: str, symbol_table_stack: List[Dict[str, Variable]]) -> Tuple[Optional[str], bool, bool]:
         """
         Resolves the type of a variable by searching through the symbol table stack.
@@ -804,7 +3274,9 @@ class CodeGenerator:
 
     def replace_globals(self, code: str) -> str:
         """
-        Replaces occurrences of StructType@member with StructType_globals.member.
+        Replaces occurrences of StructType@member with StructType_globals.member, or with the
+        StructType_member array for @table globals. StructType@fields and StructType@field_count
+        name the field descriptor table of reflected structs.
         
         Args:
             code (str): The code to process.
@@ -817,12 +3289,19 @@ class CodeGenerator:
         for struct_name, metadata in self.struct_metadata.items():
             logger.info(f"checking {struct_name}");
             logger.debug(f"{struct_name} metadata is {metadata}");
-            for global_member in metadata.globals.keys():
+            for global_member, var in metadata.globals.items():
                 logger.debug(f"member is {global_member}")
                 pattern = rf'\b{struct_name}@{global_member}\b'
-                replacement = f"({struct_name}_globals.{global_member})"
+                replacement = f"({self.globals_object(struct_name, global_member)}.{global_member})"
+                if "table" in var.attributes:
+                    replacement = f"{struct_name}_{global_member}"
                 updated_code = re.sub(pattern, replacement, updated_code)
                 logger.debug(f"Replaced '{struct_name}@{global_member}' with '{replacement}'")
+            if self.reflects(struct_name):
+                if "fields" not in metadata.globals:
+                    updated_code = re.sub(rf'\b{struct_name}@fields\b', f"{struct_name}_fields", updated_code)
+                if "field_count" not in metadata.globals:
+                    updated_code = re.sub(rf'\b{struct_name}@field_count\b', f"{struct_name}_FIELD_COUNT", updated_code)
         logger.info("Global variable accesses replaced successfully")
         return updated_code
 
@@ -871,15 +3350,1192 @@ class CodeGenerator:
         logger.info("Function pointer replacement completed")
         return updated_code
 
+    def generate_bench_runner(self, code: str) -> str:
+        """
+        Registers @bench methods in an ns_benchmarks table and appends a runner with its own main.
+        The program's main is renamed to ns_program_main so the runner can take its place.
+
+        Args:
+            code (str): The code to process.
+
+        Returns:
+            str: The code with the benchmark table and runner appended.
+        """
+        thunks = []
+        entries = []
+        for struct_name, metadata in self.struct_metadata.items():
+            for method in metadata.methods.values():
+                if "bench" not in method.attributes:
+                    continue
+                if method.arguments:
+                    error_msg = f"Benchmark '{struct_name}@{method.name}' can only take self."
+                    logger.error(error_msg)
+                    raise TransformationError(error_msg)
+                index = len(entries)
+                return_type = f"{method.return_type} {'*' * method.ptr_level}".strip()
+                # Inputs pass through an empty asm the compiler cannot see through, so calls are not folded
+                if method.has_self:
+                    # Methods with self run against a zero initialized object owned by the runner
+                    thunks.append(f"static {struct_name}_t ns_bench_object_{index};\n")
+                    body = (
+                        f"    {struct_name}_t *ns_self = &ns_bench_object_{index};\n"
+                        f"    __asm__ volatile(\"\" : \"+r\"(ns_self) : : \"memory\");\n"
+                    )
+                    call = f"{struct_name}_{method.name}(ns_self)"
+                else:
+                    # Without arguments the only input is the function itself
+                    body = (
+                        f"    {return_type} (*ns_run)(void) = {struct_name}_{method.name};\n"
+                        f"    __asm__ volatile(\"\" : \"+r\"(ns_run));\n"
+                    )
+                    call = "ns_run()"
+                if return_type == "void":
+                    body += f"    {call};\n"
+                else:
+                    # Let the result escape so the call cannot be optimized away
+                    body += (
+                        f"    {return_type} ns_result = {call};\n"
+                        f"    __asm__ volatile(\"\" : : \"g\"(&ns_result) : \"memory\");\n"
+                    )
+                thunks.append(f"static void ns_bench_thunk_{index}(void) {{\n{body}}}\n")
+                entries.append(f'    {{"{struct_name}@{method.name}", ns_bench_thunk_{index}}},\n')
+                logger.debug(f"Registered benchmark {struct_name}@{method.name}")
+
+        if not entries:
+            error_msg = "--bench needs at least one @bench method."
+            logger.error(error_msg)
+            raise TransformationError(error_msg)
+        self.require_support("bench")
+        # Only a real definition of main is renamed, not one in a comment or string
+        for match in reversed(list(re.finditer(r"\bint\s+main\s*\(", blank_comments_and_literals(code)))):
+            code = code[:match.start()] + "int ns_program_main(" + code[match.end():]
+        table = (
+            "\ntypedef struct ns_benchmark {\n"
+            "    const char *name;\n"
+            "    void (*run)(void);\n"
+            "} ns_benchmark;\n"
+            f"{''.join(thunks)}"
+            f"static const ns_benchmark ns_benchmarks[] = {{\n{''.join(entries)}}};\n"
+            "#define NS_BENCH_COUNT (sizeof ns_benchmarks / sizeof ns_benchmarks[0])\n"
+        )
+        return code + table + BENCH_RUNNER
+
+    def unroll_loops(self, code: str) -> str:
+        """
+        Lowers `@unroll(N) for (...)` loops. Counted loops with a constant trip count of at most
+        MAX_FULL_UNROLL iterations are unrolled completely, other counted loops get N copies of the
+        body plus a remainder loop, and loops the transpiler cannot unroll safely get NS_UNROLL(N).
+
+        Args:
+            code (str): The code to process.
+
+        Returns:
+            str: The updated code with unroll annotations lowered.
+        """
+        pattern = re.compile(self.UNROLL_PATTERN)
+        match = pattern.search(code)
+        while match:
+            open_index = code.index('(', match.end())
+            close_index = find_closing_bracket(code, open_index)
+            body_start = close_index + 1
+            while body_start < len(code) and code[body_start].isspace():
+                body_start += 1
+            if close_index < 0 or body_start >= len(code):
+                raise TransformationError("Unbalanced @unroll loop header.")
+            if code[body_start] == '{':
+                body_end = find_closing_bracket(code, body_start)
+                body = code[body_start + 1:body_end]
+            else:
+                body_end = ColdPathOutliner().find_statement_end(code, body_start)
+                body = code[body_start:body_end + 1]
+            if body_end < 0:
+                raise TransformationError("Could not find the body of an @unroll loop.")
+            line_start = code.rfind('\n', 0, match.start()) + 1
+            indent = re.match(r"[ \t]*", code[line_start:]).group(0)
+            loop = code[match.end():body_end + 1]
+            replacement = self.unroll_loop(match.group(1), code[open_index + 1:close_index], body, loop, indent, code)
+            code = code[:match.start()] + replacement + code[body_end + 1:]
+            # Copies of the body may hold nested @unroll loops of their own
+            match = pattern.search(code, match.start())
+        return code
+
+    def unroll_loop(self, factor: Optional[str], header: str, body: str, loop: str, indent: str, code: str = "") -> str:
+        """
+        Unrolls one loop annotated with @unroll.
+
+        Args:
+            factor (Optional[str]): The N of @unroll(N), or None for a bare @unroll.
+            header (str): The text between the parentheses of the for statement.
+            body (str): The loop body, without its braces.
+            loop (str): The whole for statement, used when the loop is left to the compiler.
+            indent (str): The indentation of the loop.
+            code (str): The code around the loop, searched for pointers to the variables of the bound.
+
+        Returns:
+            str: The replacement code.
+        """
+        def fallback(reason: str) -> str:
+            logger.debug(f"Leaving @unroll loop to the compiler: {reason}")
+            if not factor:
+                logger.warning(f"@unroll without a factor left a loop as is: {reason}")
+                return loop
+            self.require_support("unroll")
+            return f"NS_UNROLL({factor})\n{indent}{loop}"
+
+        parts = [part.strip() for part in header.split(';')]
+        if len(parts) != 3:
+            return fallback("the header is not init; condition; step")
+        init = re.match(self.LOOP_INIT_PATTERN, parts[0])
+        condition = re.match(self.LOOP_CONDITION_PATTERN, parts[1])
+        step = re.match(self.LOOP_STEP_PATTERN, parts[2])
+        if not init or not condition or not step:
+            return fallback("the loop is not a counted loop")
+        var_type, var, start = init.group(1), init.group(2), init.group(3).strip()
+        _, comparison, end = condition.groups()
+        step_var = step.group(2) or step.group(3) or step.group(5)
+        if condition.group(1) != var or step_var != var or (var_type and var_type.split()[0] == "const"):
+            return fallback("the condition and step do not use the initialized variable")
+        # Copies and the remainder loop only stay equivalent when nothing else leaves or changes an iteration
+        if re.search(r"\b(?:break|continue|goto|static)\b", body) or re.search(r"(?m)^\s*(?!case\b|default\b)\w+\s*:(?!:)", body):
+            return fallback("the body has jumps, labels or static locals")
+        if re.search(rf"(?:\b{var}\s*(?:[-+*/%&|^]|<<|>>)?=(?!=)|\+\+\s*{var}\b|--\s*{var}\b|\b{var}\s*(?:\+\+|--)|&\s*{var}\b)", body):
+            return fallback(f"the body changes or takes the address of '{var}'")
+
+        evaluator = self.constant_evaluator()
+        try:
+            if step.group(1) or step.group(4):
+                increment = 1 if (step.group(1) or step.group(4)) == "++" else -1
+            else:
+                increment, _ = evaluator.evaluate(step.group(7))
+                increment = -increment if step.group(6) == '-' else increment
+        except TransformationError:
+            return fallback("the step is not constant")
+        if increment == 0 or (comparison in ("<", "<=") and increment < 0) or (comparison in (">", ">=") and increment > 0):
+            return fallback("the step does not move towards the bound")
+
+        inner = indent + "    "
+        copy_body = body.strip('\n')
+        try:
+            ctype = evaluator.parse_type(var_type) if var_type else ConstantEvaluator.INT
+            value = evaluator.convert(evaluator.evaluate(start)[0], ctype)
+            bound = evaluator.parse(f"{var} {comparison} ({end})")
+            values = []
+            while evaluator.evaluate_parsed(bound, {var: (value, ctype)})[0] and len(values) <= self.MAX_FULL_UNROLL:
+                values.append(value)
+                value = evaluator.convert(value + increment, ctype)
+        except TransformationError:
+            values = None
+        if values is not None and len(values) <= self.MAX_FULL_UNROLL:
+            logger.debug(f"Fully unrolling a loop of {len(values)} iterations over '{var}'")
+            copies = []
+            # value keeps the first failing value, which an outer variable holds after the loop
+            for iteration_value in values:
+                literal = evaluator.format_constant(iteration_value, ctype)
+                if var_type:
+                    copies.append(f"{inner}{{\n{inner}    const {var_type} {var} = {literal};\n{copy_body}\n{inner}}}\n")
+                else:
+                    copies.append(f"{inner}{var} = {literal};\n{inner}{{\n{copy_body}\n{inner}}}\n")
+            if not var_type:
+                copies.append(f"{inner}{var} = {evaluator.format_constant(value, ctype)};\n")
+            return f"{{\n{''.join(copies)}{indent}}}"
+
+        if not factor or not factor.isdigit() or int(factor) < 2:
+            return fallback("the trip count is not constant and there is no factor above one")
+        if comparison == "!=":
+            return fallback("a != bound cannot be checked several iterations ahead")
+        # The bound is only checked once per block of copies, so the body must not be able to move it
+        blanked_body = blank_comments_and_literals(body)
+        bound_names = set(re.findall(r"\b[A-Za-z_]\w*\b", blank_comments_and_literals(end))) - {var, "sizeof"}
+        for name in bound_names:
+            if re.search(rf"(?:\b{name}\s*(?:[-+*/%&|^]|<<|>>)?=(?!=)|\+\+\s*{name}\b|--\s*{name}\b|\b{name}\s*(?:\+\+|--)|&\s*{name}\b)", blanked_body):
+                return fallback(f"the body changes or takes the address of '{name}' from the bound")
+        if bound_names:
+            calls = re.search(r"\b(?!(?:if|for|while|switch|return|sizeof)\b)\w+\s*\(", blanked_body)
+            stores = re.search(r"(?:\*\s*\w+|->\s*\w+|\]|\.\s*\w+)\s*(?:[-+*/%&|^]|<<|>>)?=(?!=)|(?:\+\+|--)\s*\*", blanked_body)
+            # A bound read through memory can change on any store or call, a plain name only through its address
+            reads_memory = re.search(r"->|\.\s*[A-Za-z_]|\[|\*|\(|@", re.sub(r"\bsizeof\s*\([^)]*\)", "", end))
+            escapes = any(re.search(rf"&\s*{name}\b", blank_comments_and_literals(code)) for name in bound_names)
+            if calls or (stores and (reads_memory or escapes)):
+                return fallback("calls or stores in the body may change the bound")
+        count = int(factor)
+        distance = f"({end}) - {var}" if increment > 0 else f"{var} - ({end})"
+        ahead = (count - 1) * abs(increment)
+        guard = f"{var} {comparison} ({end}) && {distance} {'>' if comparison in ('<', '>') else '>='} {ahead}"
+        advance = f"{var} += {increment};" if increment > 0 else f"{var} -= {-increment};"
+        declaration = f"{var_type} {var} = {start};" if var_type else f"{var} = {start};"
+        copies = ''.join(f"{inner}    {{\n{copy_body}\n{inner}    }}\n{inner}    {advance}\n" for _ in range(count))
+        logger.debug(f"Unrolling a loop over '{var}' {count} times with a remainder loop")
+        return (
+            f"{{\n"
+            f"{inner}{declaration}\n"
+            f"{inner}for (; {guard}; ) {{\n"
+            f"{copies}"
+            f"{inner}}}\n"
+            f"{inner}for (; {parts[1]}; {parts[2]}) {{\n"
+            f"{copy_body}\n"
+            f"{inner}}}\n"
+            f"{indent}}}"
+        )
+
+    def replace_branch_hints(self, code: str) -> str:
+        """
+        Replaces likely(cond) and unlikely(cond) annotations with the NS_LIKELY and NS_UNLIKELY
+        wrappers around __builtin_expect. Comments and string literals are left alone.
+
+        Args:
+            code (str): The code to process.
+
+        Returns:
+            str: The updated code with branch hints lowered.
+        """
+        logger.info("Replacing branch hints")
+        updated_code = code
+        blanked = blank_comments_and_literals(code)
+        # Rewriting from the end keeps the offsets of earlier matches valid
+        for match in reversed(list(re.finditer(self.BRANCH_HINT_PATTERN, blanked))):
+            # Leave preprocessor lines (e.g. a user's own likely macro) untouched
+            line_prefix = blanked[blanked.rfind('\n', 0, match.start()) + 1:match.start()]
+            if line_prefix.lstrip().startswith('#'):
+                continue
+            open_index = match.end() - 1
+            close_index = find_closing_bracket(updated_code, open_index)
+            if close_index < 0:
+                error_msg = f"Unbalanced parentheses in '{match.group(1)}' annotation."
+                logger.error(error_msg)
+                raise TransformationError(error_msg)
+            condition = updated_code[open_index + 1:close_index].strip()
+            macro = "NS_LIKELY" if match.group(1) == "likely" else "NS_UNLIKELY"
+            replacement = f"{macro}({condition})"
+            self.require_support("branch_hints")
+            updated_code = updated_code[:match.start(1)] + replacement + updated_code[close_index + 1:]
+            logger.debug(f"Replaced '{match.group(1)}({condition})' with '{replacement}'")
+        logger.info("Branch hints replaced successfully")
+        return updated_code
+
+# Constant Evaluator Class (Helper for CodeGenerator)
+class BreakSignal(Exception):
+    """Unwinds a break statement during constant evaluation."""
+
+class ContinueSignal(Exception):
+    """Unwinds a continue statement during constant evaluation."""
+
+class ReturnSignal(Exception):
+    """Unwinds a return statement during constant evaluation, carrying the returned value."""
+    def __init__(self, value):
+        super().__init__()
+        self.value = value
+
+@dataclass(frozen=True)
+class CType:
+    """An arithmetic C type as seen by the constant evaluator."""
+    name: str
+    width: int
+    signed: bool
+    floating: bool = False
+
+class ConstantEvaluator:
+    """
+    Evaluates C at transpile time with the widths, signedness and conversion rules of an LP64 target.
+    Expressions cover @table and @constexpr global initializers, and a statement subset (declarations,
+    assignments, if, for, while, do, return, break, continue) runs the bodies of @constexpr methods.
+    """
+    TOKEN_PATTERN = (
+        r"\s*(?:(?P<number>(?:0[xX][0-9a-fA-F]+|\d+\.\d*(?:[eE][+-]?\d+)?|\.\d+(?:[eE][+-]?\d+)?|\d+(?:[eE][+-]?\d+)?)[uUlLfF]*)"
+        r"|(?P<char>'(?:\\.|[^'\\])+')"
+        r"|(?P<name>\w+@\w+|[A-Za-z_]\w*)"
+        r"|(?P<op><<=|>>=|\+\+|--|<<|>>|<=|>=|==|!=|&&|\|\||[-+*/%&|^]=|[-+*/%&|^~!<>?:=(),\[\]{};]))"
+    )
+    TYPE_WORDS = {"const", "volatile", "signed", "unsigned", "char", "short", "int", "long", "float", "double", "_Bool", "bool"}
+    TYPEDEFS = {
+        "size_t": (64, False), "ssize_t": (64, True), "ptrdiff_t": (64, True),
+        "intptr_t": (64, True), "uintptr_t": (64, False),
+        "int8_t": (8, True), "uint8_t": (8, False), "int16_t": (16, True), "uint16_t": (16, False),
+        "int32_t": (32, True), "uint32_t": (32, False), "int64_t": (64, True), "uint64_t": (64, False),
+    }
+    BINARY_PRECEDENCE = {
+        "||": 1, "&&": 2, "|": 3, "^": 4, "&": 5, "==": 6, "!=": 6, "<": 7, ">": 7, "<=": 7, ">=": 7,
+        "<<": 8, ">>": 8, "+": 9, "-": 9, "*": 10, "/": 10, "%": 10,
+    }
+    ESCAPES = {"n": 10, "t": 9, "r": 13, "0": 0, "a": 7, "b": 8, "f": 12, "v": 11, "\\": 92, "'": 39, '"': 34, "?": 63}
+    ASSIGNMENT_OPERATORS = ("=", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "<<=", ">>=")
+    # Bounds keeping a runaway @constexpr method from stalling the transpiler
+    MAX_STEPS = 250000
+    MAX_CALL_DEPTH = 64
+    INT = CType("int", 32, True)
+    SIZE = CType("size_t", 64, False)
+    DOUBLE = CType("double", 64, True, True)
+
+    def __init__(self, resolve=None, methods: Optional[Dict[str, Method]] = None, results: Optional[Dict] = None,
+                 resolve_type=None):
+        self.resolve = resolve
+        # Declared types of globals, so the untaken arm of ?: is typed without being evaluated
+        self.resolve_type = resolve_type
+        self.methods = methods or {}
+        # @constexpr methods are pure, so results are shared by every call with the same arguments
+        self.results = {} if results is None else results
+        self.type_cache: Dict[str, CType] = {}
+        self.scopes: List[Dict[str, List]] = [{}]
+        self.parsed_bodies: Dict[str, List] = {}
+        self.steps = 0
+        self.depth = 0
+
+    def parse_type(self, text: str) -> CType:
+        """Parses an arithmetic C type name such as `unsigned char` or `uint32_t`."""
+        if text not in self.type_cache:
+            self.type_cache[text] = self.parse_type_words(text)
+        return self.type_cache[text]
+
+    def parse_type_words(self, text: str) -> CType:
+        words = [word for word in text.split() if word not in ("const", "volatile")]
+        if len(words) == 1 and words[0] in self.TYPEDEFS:
+            width, signed = self.TYPEDEFS[words[0]]
+            return CType(words[0], width, signed)
+        if not words or any(word not in self.TYPE_WORDS for word in words):
+            raise TransformationError(f"Type '{text}' is not an arithmetic type the constant evaluator knows.")
+        name = ' '.join(words)
+        if "float" in words:
+            return CType(name, 32, True, True)
+        if "double" in words:
+            return CType(name, 64, True, True)
+        if "_Bool" in words or "bool" in words:
+            return CType("_Bool", 8, False)
+        width = 8 if "char" in words else 16 if "short" in words else 64 if "long" in words else 32
+        return CType(name, width, "unsigned" not in words)
+
+    def tokenize(self, text: str) -> List[Tuple[str, str]]:
+        """Splits C source into (kind, text) tokens."""
+        tokens = []
+        position = 0
+        text = text.rstrip()
+        while position < len(text):
+            match = re.compile(self.TOKEN_PATTERN).match(text, position)
+            if not match or match.end() == position:
+                raise TransformationError(f"Unexpected text '{text[position:position + 20]}' in constant expression.")
+            tokens.append((match.lastgroup, match.group(match.lastgroup)))
+            position = match.end()
+        return tokens
+
+    def evaluate(self, text: str, variables: Optional[Dict[str, Tuple[object, CType]]] = None) -> Tuple[object, CType]:
+        """
+        Evaluates a constant expression.
+
+        Args:
+            text (str): The C expression.
+            variables (Optional[Dict[str, Tuple[object, CType]]]): Values of the names it may use.
+
+        Returns:
+            Tuple[object, CType]: The value and its C type.
+        """
+        return self.evaluate_parsed(self.parse(text), variables)
+
+    def evaluate_parsed(self, node, variables: Optional[Dict[str, Tuple[object, CType]]] = None) -> Tuple[object, CType]:
+        """Evaluates an expression returned by parse with the given variable values."""
+        self.scopes = [{name: list(value) for name, value in (variables or {}).items()}]
+        self.steps = 0
+        try:
+            return self.evaluate_node(node)
+        except RecursionError:
+            raise TransformationError("Constant evaluation nested too deeply.")
+
+    def parse(self, text: str):
+        """Parses a constant expression once, for evaluation with different variable values."""
+        self.tokens = self.tokenize(text)
+        self.position = 0
+        node = self.parse_expression()
+        if self.position != len(self.tokens):
+            raise TransformationError(f"Unexpected '{self.tokens[self.position][1]}' in constant expression '{text}'.")
+        return node
+
+    # Parsing: nodes are tuples tagged by their first element
+
+    def peek(self, offset: int = 0) -> Optional[str]:
+        index = self.position + offset
+        return self.tokens[index][1] if index < len(self.tokens) else None
+
+    def expect(self, text: str):
+        if self.peek() != text:
+            raise TransformationError(f"Expected '{text}' but found '{self.peek()}' in constant expression.")
+        self.position += 1
+
+    def parse_expression(self):
+        target = self.parse_conditional()
+        if self.peek() not in self.ASSIGNMENT_OPERATORS:
+            return target
+        op = self.peek()
+        self.position += 1
+        return ("assign", op, target, self.parse_expression())
+
+    def parse_conditional(self):
+        condition = self.parse_binary(1)
+        if self.peek() != '?':
+            return condition
+        self.position += 1
+        when_true = self.parse_expression()
+        self.expect(':')
+        return ("ternary", condition, when_true, self.parse_conditional())
+
+    def parse_binary(self, min_precedence: int):
+        left = self.parse_unary()
+        while self.peek() in self.BINARY_PRECEDENCE and self.BINARY_PRECEDENCE[self.peek()] >= min_precedence:
+            op = self.peek()
+            self.position += 1
+            left = ("binary", op, left, self.parse_binary(self.BINARY_PRECEDENCE[op] + 1))
+        return left
+
+    def starts_type(self, offset: int) -> bool:
+        word = self.peek(offset)
+        return word is not None and (word in self.TYPE_WORDS or word in self.TYPEDEFS)
+
+    def parse_type_name(self) -> CType:
+        words = []
+        while self.starts_type(0):
+            words.append(self.peek())
+            self.position += 1
+        if self.peek() == '*':
+            raise TransformationError("Pointer types are not supported in constant expressions.")
+        return self.parse_type(' '.join(words))
+
+    def parse_unary(self):
+        token = self.peek()
+        if token in ('-', '+', '!', '~'):
+            self.position += 1
+            return ("unary", token, self.parse_unary())
+        if token in ("++", "--"):
+            self.position += 1
+            return ("increment", token, self.parse_unary(), True)
+        if token == '(' and self.starts_type(1):
+            self.position += 1
+            ctype = self.parse_type_name()
+            self.expect(')')
+            return ("cast", ctype, self.parse_unary())
+        if token == "sizeof":
+            self.position += 1
+            self.expect('(')
+            ctype = self.parse_type_name()
+            self.expect(')')
+            return ("constant", ctype.width // 8, self.SIZE)
+        return self.parse_postfix(self.parse_primary())
+
+    def parse_postfix(self, node):
+        while self.peek() in ('[', '(', "++", "--"):
+            token = self.peek()
+            self.position += 1
+            if token == '[':
+                index = self.parse_expression()
+                self.expect(']')
+                node = ("index", node, index)
+            elif token == '(':
+                if node[0] != "name":
+                    raise TransformationError("Only named methods can be called in constant expressions.")
+                args = []
+                while self.peek() != ')':
+                    args.append(self.parse_expression())
+                    if self.peek() != ')':
+                        self.expect(',')
+                self.expect(')')
+                node = ("call", node[1], args)
+            else:
+                node = ("increment", token, node, False)
+        return node
+
+    def parse_statements(self, text: str) -> List:
+        """Parses a method body into a list of statement nodes."""
+        text = re.sub(r"//[^\n]*|/\*[\s\S]*?\*/", " ", text)
+        self.tokens = self.tokenize(text)
+        self.position = 0
+        statements = []
+        while self.position < len(self.tokens):
+            statements.append(self.parse_statement())
+        return statements
+
+    def parse_statement(self):
+        token = self.peek()
+        if token == '{':
+            self.position += 1
+            statements = []
+            while self.peek() != '}':
+                if self.peek() is None:
+                    raise TransformationError("Unclosed block in @constexpr method.")
+                statements.append(self.parse_statement())
+            self.position += 1
+            return ("block", statements)
+        if token == ';':
+            self.position += 1
+            return ("block", [])
+        if token in ("if", "while"):
+            self.position += 1
+            self.expect('(')
+            condition = self.parse_expression()
+            self.expect(')')
+            body = self.parse_statement()
+            if token == "while":
+                return ("for", None, condition, None, body)
+            otherwise = None
+            if self.peek() == "else":
+                self.position += 1
+                otherwise = self.parse_statement()
+            return ("if", condition, body, otherwise)
+        if token == "do":
+            self.position += 1
+            body = self.parse_statement()
+            self.expect("while")
+            self.expect('(')
+            condition = self.parse_expression()
+            self.expect(')')
+            self.expect(';')
+            return ("do", body, condition)
+        if token == "for":
+            self.position += 1
+            self.expect('(')
+            if self.starts_type(0):
+                init = self.parse_declaration()
+            else:
+                init = ("expression", self.parse_expression()) if self.peek() != ';' else None
+                self.expect(';')
+            condition = self.parse_expression() if self.peek() != ';' else None
+            self.expect(';')
+            step = self.parse_expression() if self.peek() != ')' else None
+            self.expect(')')
+            # The for scope holds the loop variable, the body gets its own block scope
+            return ("block", [init, ("for", None, condition, step, self.parse_statement())] if init else
+                    [("for", None, condition, step, self.parse_statement())])
+        if token in ("break", "continue"):
+            self.position += 1
+            self.expect(';')
+            return (token,)
+        if token == "return":
+            self.position += 1
+            value = self.parse_expression() if self.peek() != ';' else None
+            self.expect(';')
+            return ("return", value)
+        if self.starts_type(0):
+            return self.parse_declaration()
+        expression = self.parse_expression()
+        self.expect(';')
+        return ("expression", expression)
+
+    def parse_declaration(self):
+        ctype = self.parse_type_name()
+        declarators = []
+        while True:
+            kind, name = self.tokens[self.position] if self.position < len(self.tokens) else (None, None)
+            if kind != "name":
+                raise TransformationError(f"Expected a variable name but found '{name}' in @constexpr method.")
+            self.position += 1
+            if self.peek() == '[':
+                raise TransformationError("Arrays are not supported in @constexpr methods.")
+            value = None
+            if self.peek() == '=':
+                self.position += 1
+                value = self.parse_conditional()
+            declarators.append((name, value))
+            if self.peek() != ',':
+                break
+            self.position += 1
+        self.expect(';')
+        return ("declare", ctype, declarators)
+
+    def parse_primary(self):
+        if self.position >= len(self.tokens):
+            raise TransformationError("Unexpected end of constant expression.")
+        kind, text = self.tokens[self.position]
+        self.position += 1
+        if text == '(':
+            node = self.parse_expression()
+            self.expect(')')
+            return node
+        if kind == "number":
+            return ("constant",) + self.number_literal(text)
+        if kind == "char":
+            return ("constant", self.char_literal(text), self.INT)
+        if kind == "name":
+            return ("name", text)
+        raise TransformationError(f"Unexpected '{text}' in constant expression.")
+
+    def number_literal(self, text: str) -> Tuple[object, CType]:
+        """Types an integer or floating literal the way C does."""
+        digits = text.rstrip("uUlL") if text.lower().startswith("0x") else text.rstrip("uUlLfF")
+        suffix = text[len(digits):].lower()
+        if not digits.lower().startswith("0x") and re.search(r"[.eE]", digits):
+            ctype = CType("float", 32, True, True) if 'f' in suffix else self.DOUBLE
+            return self.convert(float(digits), ctype), ctype
+        if digits.lower().startswith("0x"):
+            value = int(digits, 16)
+        elif len(digits) > 1 and digits.startswith('0'):
+            value = int(digits, 8)
+        else:
+            value = int(digits)
+        decimal = not digits.startswith('0') or digits == '0'
+        candidates = [CType("int", 32, True), CType("unsigned int", 32, False),
+                      CType("long", 64, True), CType("unsigned long", 64, False)]
+        if 'u' in suffix:
+            candidates = [ctype for ctype in candidates if not ctype.signed]
+        elif decimal:
+            candidates = [ctype for ctype in candidates if ctype.signed]
+        if 'l' in suffix:
+            candidates = [ctype for ctype in candidates if ctype.width == 64]
+        for ctype in candidates:
+            if value < 2 ** (ctype.width - 1 if ctype.signed else ctype.width):
+                return value, ctype
+        raise TransformationError(f"Integer literal {text} is too large.")
+
+    def char_literal(self, text: str) -> int:
+        body = text[1:-1]
+        if not body.startswith('\\'):
+            value = ord(body)
+        elif body[1] == 'x':
+            value = int(body[2:], 16)
+        elif body[1].isdigit():
+            value = int(body[1:], 8)
+        elif body[1] in self.ESCAPES:
+            value = self.ESCAPES[body[1]]
+        else:
+            raise TransformationError(f"Unknown escape in character literal {text}.")
+        # Plain char is signed, so '\xff' is -1
+        return self.convert(value, CType("char", 8, True))
+
+    # Evaluation
+
+    def convert(self, value, ctype: CType):
+        """Converts a value to a C type, wrapping integers to its width."""
+        if ctype.floating:
+            value = float(value)
+            if ctype.width != 32:
+                return value
+            try:
+                return struct.unpack('f', struct.pack('f', value))[0]
+            except OverflowError:
+                # IEEE rounding of a double beyond the float range gives an infinity
+                return float("inf") if value > 0 else float("-inf")
+        if ctype.name == "_Bool":
+            return 1 if value else 0
+        if isinstance(value, float):
+            if value != value or value in (float("inf"), float("-inf")):
+                raise TransformationError("Converting a non finite value to an integer type.")
+            value = int(value)
+        value &= (1 << ctype.width) - 1
+        if ctype.signed and value >= 1 << (ctype.width - 1):
+            value -= 1 << ctype.width
+        return value
+
+    def promote(self, ctype: CType) -> CType:
+        return self.INT if not ctype.floating and ctype.width < 32 else ctype
+
+    def common_type(self, left: CType, right: CType) -> CType:
+        """Applies the usual arithmetic conversions."""
+        if left.floating or right.floating:
+            if left.floating and right.floating:
+                return left if left.width >= right.width else right
+            return left if left.floating else right
+        left, right = self.promote(left), self.promote(right)
+        if left.signed == right.signed:
+            return left if left.width >= right.width else right
+        unsigned, signed = (left, right) if not left.signed else (right, left)
+        return unsigned if unsigned.width >= signed.width else signed
+
+    def evaluate_node(self, node) -> Tuple[object, CType]:
+        kind = node[0]
+        if kind == "constant":
+            return node[1], node[2]
+        if kind == "name":
+            return self.evaluate_name(node[1])
+        if kind == "cast":
+            value, _ = self.evaluate_node(node[2])
+            return self.convert(value, node[1]), node[1]
+        if kind == "index":
+            return self.evaluate_index(node)
+        if kind == "ternary":
+            condition, _ = self.evaluate_node(node[1])
+            # The result has the common type of both arms, but only the chosen one is evaluated
+            value, _ = self.evaluate_node(node[2] if condition else node[3])
+            ctype = self.common_type(self.node_type(node[2]), self.node_type(node[3]))
+            return self.convert(value, ctype), ctype
+        if kind == "unary":
+            return self.evaluate_unary(node[1], *self.evaluate_node(node[2]))
+        if kind == "binary":
+            return self.evaluate_binary(node[1], node[2], node[3])
+        if kind == "assign":
+            slot = self.lookup(node[2])
+            if node[1] == '=':
+                value, _ = self.evaluate_node(node[3])
+            else:
+                value, _ = self.evaluate_binary(node[1][:-1], ("constant", slot[0], slot[1]), node[3])
+            slot[0] = self.convert(value, slot[1])
+            return slot[0], slot[1]
+        if kind == "increment":
+            slot = self.lookup(node[2])
+            previous = slot[0]
+            value, _ = self.evaluate_binary(node[1][0], ("constant", previous, slot[1]), ("constant", 1, self.INT))
+            slot[0] = self.convert(value, slot[1])
+            return (slot[0] if node[3] else previous), slot[1]
+        if kind == "call":
+            return self.call(node[1], [self.evaluate_node(arg) for arg in node[2]])
+        raise TransformationError(f"Unsupported construct '{kind}' in constant expression.")
+
+    def lookup(self, node) -> List:
+        """Finds the [value, type] slot of an assignable local."""
+        if node[0] == "name":
+            for scope in reversed(self.scopes):
+                if node[1] in scope:
+                    return scope[node[1]]
+        raise TransformationError("Only local variables can be assigned in constant evaluation.")
+
+    def call(self, name: str, args: List[Tuple[object, CType]]) -> Tuple[object, CType]:
+        """
+        Runs a @constexpr method on constant arguments.
+
+        Args:
+            name (str): The method as Type@name.
+            args (List[Tuple[object, CType]]): The argument values and types.
+
+        Returns:
+            Tuple[object, CType]: The returned value converted to the return type.
+        """
+        method = self.methods.get(name)
+        if not method:
+            raise TransformationError(f"'{name}' is not a @constexpr method.")
+        # A lone 'void' declares no parameters, the same as an empty list.
+        parameters = [] if [split_argument(arg) for arg in method.arguments] == [("", "void")] else method.arguments
+        if len(args) != len(parameters):
+            raise TransformationError(f"'{name}' takes {len(parameters)} arguments, not {len(args)}.")
+        if self.depth >= self.MAX_CALL_DEPTH:
+            raise TransformationError(f"Constant evaluation of '{name}' recursed deeper than {self.MAX_CALL_DEPTH} calls.")
+        frame = {}
+        for arg, (value, _) in zip(parameters, args):
+            arg_type, arg_name = split_argument(arg)
+            ctype = self.parse_type(arg_type)
+            frame[arg_name] = [self.convert(value, ctype), ctype]
+        key = (name,) + tuple(value for value, _ in frame.values())
+        if key in self.results:
+            return self.results[key]
+        if name not in self.parsed_bodies:
+            self.parsed_bodies[name] = self.parse_statements(method.body)
+        return_type = self.parse_type(f"{method.return_type} {'*' * method.ptr_level}")
+        saved_scopes = self.scopes
+        self.scopes = [frame]
+        self.depth += 1
+        try:
+            self.execute_block(self.parsed_bodies[name])
+        except ReturnSignal as signal:
+            if signal.value is None:
+                raise TransformationError(f"'{name}' returned without a value.")
+            self.results[key] = (self.convert(signal.value[0], return_type), return_type)
+            return self.results[key]
+        finally:
+            self.scopes = saved_scopes
+            self.depth -= 1
+        raise TransformationError(f"'{name}' ended without returning a value.")
+
+    def execute_block(self, statements: List):
+        self.scopes.append({})
+        try:
+            for statement in statements:
+                self.execute(statement)
+        finally:
+            self.scopes.pop()
+
+    def execute(self, statement):
+        """Runs one statement, signalling break, continue and return with exceptions."""
+        self.steps += 1
+        if self.steps > self.MAX_STEPS:
+            raise TransformationError(f"Constant evaluation ran for more than {self.MAX_STEPS} steps.")
+        kind = statement[0]
+        if kind == "block":
+            self.execute_block(statement[1])
+        elif kind == "expression":
+            self.evaluate_node(statement[1])
+        elif kind == "declare":
+            for name, value in statement[2]:
+                initial = self.evaluate_node(value)[0] if value else 0
+                self.scopes[-1][name] = [self.convert(initial, statement[1]), statement[1]]
+        elif kind == "if":
+            if self.evaluate_node(statement[1])[0]:
+                self.execute(statement[2])
+            elif statement[3]:
+                self.execute(statement[3])
+        elif kind in ("for", "do"):
+            body, condition, step = (statement[4], statement[2], statement[3]) if kind == "for" else (statement[1], statement[2], None)
+            first = kind == "do"
+            while first or condition is None or self.evaluate_node(condition)[0]:
+                first = False
+                self.steps += 1
+                if self.steps > self.MAX_STEPS:
+                    raise TransformationError(f"Constant evaluation ran for more than {self.MAX_STEPS} steps.")
+                try:
+                    self.execute(body)
+                except BreakSignal:
+                    break
+                except ContinueSignal:
+                    pass
+                if step:
+                    self.evaluate_node(step)
+        elif kind == "break":
+            raise BreakSignal()
+        elif kind == "continue":
+            raise ContinueSignal()
+        elif kind == "return":
+            raise ReturnSignal(self.evaluate_node(statement[1]) if statement[1] else None)
+
+    def node_type(self, node) -> CType:
+        """Finds the C type of an expression without evaluating it."""
+        kind = node[0]
+        if kind == "constant":
+            return node[2]
+        if kind == "cast":
+            return node[1]
+        if kind == "ternary":
+            return self.common_type(self.node_type(node[2]), self.node_type(node[3]))
+        if kind == "unary":
+            return self.INT if node[1] == '!' else self.promote(self.node_type(node[2]))
+        if kind == "binary":
+            if node[1] in ("&&", "||", "==", "!=", "<", ">", "<=", ">="):
+                return self.INT
+            if node[1] in ("<<", ">>"):
+                return self.promote(self.node_type(node[2]))
+            return self.common_type(self.node_type(node[2]), self.node_type(node[3]))
+        if kind in ("assign", "increment"):
+            return self.lookup(node[2])[1]
+        if kind == "name":
+            for scope in reversed(self.scopes):
+                if node[1] in scope:
+                    return scope[node[1]][1]
+            if node[1] in ("true", "false"):
+                return self.INT
+        if kind in ("name", "index"):
+            name = node[1] if kind == "name" else node[1][1] if node[1][0] == "name" else ""
+            if '@' in name and self.resolve_type:
+                return self.resolve_type(name)
+            return self.evaluate_node(node)[1]
+        if kind == "call":
+            if node[1] not in self.methods:
+                raise TransformationError(f"'{node[1]}' is not a @constexpr method.")
+            method = self.methods[node[1]]
+            return self.parse_type(f"{method.return_type} {'*' * method.ptr_level}")
+        raise TransformationError(f"Unsupported construct '{kind}' in constant expression.")
+
+    def evaluate_name(self, name: str) -> Tuple[object, CType]:
+        for scope in reversed(self.scopes):
+            if name in scope:
+                return scope[name][0], scope[name][1]
+        if name in ("true", "false"):
+            return (1 if name == "true" else 0), self.INT
+        if '@' in name and self.resolve:
+            value, ctype = self.resolve(name)
+            if isinstance(value, list):
+                raise TransformationError(f"@table '{name}' needs an index.")
+            return value, ctype
+        raise TransformationError(f"'{name}' is not a constant.")
+
+    def evaluate_index(self, node) -> Tuple[object, CType]:
+        if node[1][0] != "name" or '@' not in node[1][1] or not self.resolve:
+            raise TransformationError("Only @table globals can be indexed in constant expressions.")
+        values, ctype = self.resolve(node[1][1])
+        if not isinstance(values, list):
+            raise TransformationError(f"'{node[1][1]}' is not a @table global.")
+        index, index_type = self.evaluate_node(node[2])
+        if index_type.floating:
+            raise TransformationError(f"Index of {node[1][1]} has floating type {index_type.name}.")
+        if not 0 <= index < len(values):
+            raise TransformationError(f"Index {index} is out of range for {node[1][1]}.")
+        return values[index], ctype
+
+    def evaluate_unary(self, op: str, value, ctype: CType) -> Tuple[object, CType]:
+        if op == '!':
+            return (0 if value else 1), self.INT
+        ctype = self.promote(ctype)
+        if op == '~':
+            if ctype.floating:
+                raise TransformationError("Operator '~' needs an integer operand.")
+            return self.convert(~value, ctype), ctype
+        return self.convert(-value if op == '-' else value, ctype), ctype
+
+    def evaluate_binary(self, op: str, left_node, right_node) -> Tuple[object, CType]:
+        left, left_type = self.evaluate_node(left_node)
+        if op in ("&&", "||"):
+            if (op == "&&") != bool(left):
+                return (1 if left else 0), self.INT
+            right, _ = self.evaluate_node(right_node)
+            return (1 if right else 0), self.INT
+        right, right_type = self.evaluate_node(right_node)
+        if op in ("<<", ">>"):
+            ctype = self.promote(left_type)
+            if ctype.floating or right_type.floating or not 0 <= right < ctype.width:
+                raise TransformationError(f"Invalid shift by {right} of a {ctype.name}.")
+            return self.convert(left << right if op == "<<" else left >> right, ctype), ctype
+        ctype = self.common_type(left_type, right_type)
+        left, right = self.convert(left, ctype), self.convert(right, ctype)
+        if op in ("==", "!=", "<", ">", "<=", ">="):
+            result = {"==": left == right, "!=": left != right, "<": left < right,
+                      ">": left > right, "<=": left <= right, ">=": left >= right}[op]
+            return (1 if result else 0), self.INT
+        if op in ("&", "|", "^", "%") and ctype.floating:
+            raise TransformationError(f"Operator '{op}' needs integer operands.")
+        if op in ("/", "%") and right == 0:
+            raise TransformationError("Division by zero in constant expression.")
+        if op == '/':
+            if ctype.floating:
+                return self.convert(left / right, ctype), ctype
+            quotient = abs(left) // abs(right)
+            return self.convert(quotient if (left < 0) == (right < 0) else -quotient, ctype), ctype
+        if op == '%':
+            quotient = abs(left) // abs(right)
+            quotient = quotient if (left < 0) == (right < 0) else -quotient
+            return self.convert(left - right * quotient, ctype), ctype
+        result = {"+": lambda: left + right, "-": lambda: left - right, "*": lambda: left * right,
+                  "&": lambda: left & right, "|": lambda: left | right, "^": lambda: left ^ right}[op]()
+        return self.convert(result, ctype), ctype
+
+    def format_constant(self, value, ctype: CType) -> str:
+        """Spells a value as a C literal of its type."""
+        if ctype.floating:
+            if value != value or value in (float("inf"), float("-inf")):
+                raise TransformationError("Non finite values cannot be written as literals.")
+            text = repr(value)
+            if not re.search(r"[.eE]", text):
+                text += ".0"
+            return text + ('f' if ctype.width == 32 else "")
+        suffix = "ll" if "long long" in ctype.name else "l" if ctype.width == 64 else ""
+        if not ctype.signed:
+            return f"{value}u{suffix}"
+        if ctype.width == 64:
+            # -9223372036854775808 is unary minus applied to a literal that does not fit
+            return f"({value + 1}{suffix} - 1)" if value == -2 ** 63 else f"{value}{suffix}"
+        return f"({value + 1} - 1)" if value == -2 ** 31 else str(value)
+
+# Cold Path Outliner Class (Helper for CodeGenerator)
+class ColdPathOutliner:
+    """
+    Moves error exit branches (exit/abort calls, stderr logging before an error return) out of
+    function bodies into cold, noinline helpers so the hot code around them stays small.
+    """
+    EXIT_PATTERN = r"^(?:exit|_Exit|quick_exit)\s*\(\s*(?:-?\d+|[A-Z_][A-Z0-9_]*)\s*\)$"
+    ABORT_PATTERN = r"^abort\s*\(\s*\)$"
+    STRING_LITERAL = r'"(?:[^"\\]|\\.)*"'
+    LOG_PATTERNS = [
+        rf"^perror\s*\(\s*{STRING_LITERAL}\s*\)$",
+        rf"^fputs\s*\(\s*{STRING_LITERAL}\s*,\s*stderr\s*\)$",
+        rf"^fprintf\s*\(\s*stderr\s*,\s*{STRING_LITERAL}\s*\)$",
+    ]
+    FORMATTED_LOG_PATTERN = rf"^fprintf\s*\(\s*stderr\s*,\s*({STRING_LITERAL})\s*,([\s\S]*)\)$"
+    ERROR_RETURN_PATTERN = r"^return\s+(?:-\s*\d+|NULL|-?\s*E[A-Z0-9_]+|\w*ERR\w*)$"
+    IF_PATTERN = r"(?<![\w.])if\s*\("
+    DECORATION_LINE_PATTERN = r"^(?:NS_\w+(?:\(.*\))?|#pragma .*)$"
+
+    def __init__(self):
+        self.helpers: Dict[str, str] = {}
+        self.helper_counts: Dict[str, int] = {}
+        self.used_support: List[str] = []
+
+    def outline(self, code: str) -> str:
+        """
+        Outlines the cold branches of every function in the code.
+
+        Args:
+            code (str): The generated code.
+
+        Returns:
+            str: The code with cold helpers defined ahead of the functions using them.
+        """
+        pieces = []
+        last = 0
+        for name, start, open_index, close_index in find_function_bodies(code):
+            new_helpers = []
+            body = self.outline_body(name, code[open_index + 1:close_index], new_helpers)
+            if not new_helpers:
+                continue
+            # Helpers go above the function's decoration lines, not between them and the signature
+            while start > 0:
+                previous_start = code.rfind('\n', 0, start - 1) + 1
+                if not re.match(self.DECORATION_LINE_PATTERN, code[previous_start:start - 1].strip()):
+                    break
+                start = previous_start
+            pieces.append(code[last:start])
+            pieces.extend(new_helpers)
+            pieces.append(code[start:open_index + 1] + body + '}')
+            last = close_index + 1
+        pieces.append(code[last:])
+        return "".join(pieces)
+
+    def outline_body(self, function_name: str, body: str, new_helpers: List[str]) -> str:
+        """
+        Rewrites the cold if branches of one function body.
+
+        Args:
+            function_name (str): The name of the enclosing function, used to name helpers.
+            body (str): The function body without its braces.
+            new_helpers (List[str]): Receives helper definitions that must precede the function.
+
+        Returns:
+            str: The rewritten body.
+        """
+        pieces = []
+        last = 0
+        pattern = re.compile(self.IF_PATTERN)
+        match = pattern.search(body)
+        while match:
+            line_prefix = body[body.rfind('\n', 0, match.start()) + 1:match.start()]
+            condition_open = match.end() - 1
+            condition_close = find_closing_bracket(body, condition_open)
+            if '//' in line_prefix or condition_close < 0:
+                match = pattern.search(body, match.end())
+                continue
+
+            branch_start = condition_close + 1
+            while branch_start < len(body) and body[branch_start].isspace():
+                branch_start += 1
+            if body.startswith('{', branch_start):
+                branch_end = find_closing_bracket(body, branch_start)
+                branch = body[branch_start + 1:branch_end]
+            else:
+                branch_end = self.find_statement_end(body, branch_start)
+                branch = body[branch_start:branch_end + 1]
+
+            statements = self.outline_branch(function_name, branch, new_helpers) if branch_end > 0 else None
+            if statements is None:
+                match = pattern.search(body, match.end())
+                continue
+            if body.startswith('{', branch_start):
+                # Braced branches keep their braces and the indentation of the if
+                indent = re.match(r"[ \t]*", line_prefix).group(0)
+                replacement = ''.join(f"\n{indent}    {statement}" for statement in statements) + f"\n{indent}}}"
+                replacement = "{" + replacement
+            elif len(statements) == 1:
+                replacement = statements[0]
+            else:
+                replacement = f"{{ {' '.join(statements)} }}"
+
+            condition = body[condition_open + 1:condition_close].strip()
+            if not condition.startswith(("NS_UNLIKELY(", "NS_LIKELY(")):
+                condition = f"NS_UNLIKELY({condition})"
+                if "branch_hints" not in self.used_support:
+                    self.used_support.append("branch_hints")
+            pieces.append(body[last:match.start()])
+            pieces.append(f"if ({condition}) {replacement}")
+            last = branch_end + 1
+            match = pattern.search(body, last)
+        pieces.append(body[last:])
+        return "".join(pieces)
+
+    def find_statement_end(self, body: str, start: int) -> int:
+        """Finds the ';' ending the statement at start, or -1 when the statement is not a simple one."""
+        i = start
+        while i < len(body):
+            char = body[i]
+            if char in "({[":
+                i = find_closing_bracket(body, i)
+                if i < 0:
+                    return -1
+            elif char in "\"'":
+                i += 1
+                while i < len(body) and body[i] != char:
+                    i += 2 if body[i] == '\\' else 1
+            elif char == '}':
+                return -1
+            elif char == ';':
+                return i
+            i += 1
+        return -1
+
+    def outline_branch(self, function_name: str, branch: str, new_helpers: List[str]) -> Optional[List[str]]:
+        """
+        Builds the replacement statements for a branch made only of cold statements.
+
+        Args:
+            function_name (str): The name of the enclosing function.
+            branch (str): The branch statements without braces.
+            new_helpers (List[str]): Receives the helper definition when a new one is created.
+
+        Returns:
+            Optional[List[str]]: The replacement statements, or None when the branch is not cold.
+        """
+        statements = split_top_level(branch, ';')
+        if not statements or '{' in branch:
+            return None
+
+        error_return = None
+        if re.match(self.ERROR_RETURN_PATTERN, statements[-1]):
+            error_return = statements.pop()
+
+        helper_lines = []
+        format_string = None
+        variadic_args = None
+        noreturn = False
+        for index, statement in enumerate(statements):
+            formatted = re.match(self.FORMATTED_LOG_PATTERN, statement)
+            if re.match(self.EXIT_PATTERN, statement) or re.match(self.ABORT_PATTERN, statement):
+                # Only the last statement may leave the program
+                if index != len(statements) - 1 or error_return:
+                    return None
+                noreturn = True
+                helper_lines.append(f"    {statement};")
+            elif any(re.match(log_pattern, statement) for log_pattern in self.LOG_PATTERNS):
+                helper_lines.append(f"    {statement};")
+            elif formatted and variadic_args is None:
+                # The format and its arguments are forwarded through a va_list, one formatted log per
+                # helper; NS_PRINTF_FORMAT keeps -Wformat checking the call site
+                variadic_args = split_top_level(formatted.group(2), ',')
+                if not variadic_args:
+                    return None
+                format_string = formatted.group(1)
+                helper_lines.extend([
+                    "    va_list args;",
+                    "    va_start(args, ns_format);",
+                    "    vfprintf(stderr, ns_format, args);",
+                    "    va_end(args);",
+                ])
+            else:
+                return None
+
+        if not helper_lines:
+            # A bare error return only needs the branch hint
+            return [f"{error_return};"] if error_return else None
+
+        if variadic_args is not None and "stdarg" not in self.used_support:
+            self.used_support.append("stdarg")
+        if "cold_path" not in self.used_support:
+            self.used_support.append("cold_path")
+        parameters = "const char *ns_format, ..." if variadic_args is not None else "void"
+        helper_body = "\n".join(helper_lines)
+        key = f"{parameters}\n{helper_body}"
+        if key not in self.helpers:
+            # Helpers are numbered per function; identical ones are shared across the file
+            count = self.helper_counts.get(function_name, 0)
+            self.helper_counts[function_name] = count + 1
+            self.helpers[key] = f"{function_name}_cold_{count}"
+            attribute = "NS_COLD_NORETURN" if noreturn else "NS_COLD_PATH"
+            if variadic_args is not None:
+                attribute += " NS_PRINTF_FORMAT(1, 2)"
+            new_helpers.append(
+                f"{attribute} static void {self.helpers[key]}({parameters}) {{\n"
+                f"{helper_body}\n"
+                f"}}\n\n"
+            )
+        call_args = f"{format_string}, {', '.join(variadic_args)}" if variadic_args is not None else ""
+        statements = [f"{self.helpers[key]}({call_args});"]
+        if error_return:
+            statements.append(f"{error_return};")
+        return statements
+
 # Main Transformer Pipeline
 class CodeTransformer:
     """
     Orchestrates the entire code transformation process by utilizing the CodeParser and CodeGenerator.
     """
-    def __init__(self, code: str,declare_in_place=False):
+    def __init__(self, code: str,declare_in_place=False, outline_cold=False, instrument=None, instrument_filter=None, profile=None, bench=False,
+                 dead_code="keep", entries=None, visibility="default"):
         self.original_code = code
         self.transformed_code = code
         self.declare_in_place = declare_in_place
+        self.outline_cold = outline_cold
+        self.instrument = instrument
+        self.instrument_filter = instrument_filter
+        self.profile = profile
+        self.bench = bench
+        self.dead_code = dead_code
+        self.entries = entries
+        self.visibility = visibility
+        self.exported_methods: List[str] = []
+        self.internal_symbols: List[str] = []
         self.struct_metadata: Dict[str, StructMetadata] = {}
         self.functions_metadata: Dict[str, FunctionMetadata] = {}
         self.global_variables: List[Variable] = []
@@ -909,9 +4565,19 @@ class CodeTransformer:
             functions_metadata=self.functions_metadata,
             global_variables=self.global_variables,
             hierarchy=self.hierarchy,
-            declare_in_place=self.declare_in_place
+            declare_in_place=self.declare_in_place,
+            outline_cold=self.outline_cold,
+            instrument=self.instrument,
+            instrument_filter=self.instrument_filter,
+            profile=self.profile,
+            bench=self.bench,
+            dead_code=self.dead_code,
+            entries=self.entries,
+            visibility=self.visibility
         )
         self.transformed_code = generator.generate()
+        self.exported_methods = generator.exported_methods
+        self.internal_symbols = generator.internal_symbols
 
         logger.info("Code Transformation Pipeline completed successfully")
 
@@ -1025,17 +4691,70 @@ class HierarchyParser:
 
         return blocks
 
+def load_profile(path: str) -> Dict[str, int]:
+    """
+    Reads a call count profile of "Type@method count" lines, summing repeated entries from several runs.
+
+    Args:
+        path (str): The profile file.
+
+    Returns:
+        Dict[str, int]: The call count of each profiled method.
+    """
+    profile: Dict[str, int] = {}
+    with open(path, "r") as infile:
+        for line in infile:
+            parts = line.split()
+            if len(parts) != 2 or not parts[1].isdigit():
+                continue
+            profile[parts[0]] = profile.get(parts[0], 0) + int(parts[1])
+    logger.debug(f"Loaded profile for {len(profile)} methods from {path}")
+    return profile
+
+def version_script(symbols: List[str], internal: List[str]) -> str:
+    """
+    Builds a linker version script that exports the given symbols and makes the other generated
+    methods and globals local. Symbols it does not list, such as the program's own functions and the
+    weak instrumentation registries shared between units, keep their default binding.
+
+    Args:
+        symbols (List[str]): The exported C symbol names.
+        internal (List[str]): The generated C symbol names to hide.
+
+    Returns:
+        str: The version script, for use with -Wl,--version-script.
+    """
+    exported = ''.join(f"    {symbol};\n" for symbol in symbols)
+    hidden = ''.join(f"    {symbol};\n" for symbol in internal)
+    global_section = f"  global:\n{exported}" if symbols else ""
+    local_section = f"  local:\n{hidden}" if internal else ""
+    return f"{{\n{global_section}{local_section}}};\n"
+
 # Entry point for file-based processing
 def main():
     parser = argparse.ArgumentParser(description="Transform C-like code.")
     parser.add_argument("input_file", help="Path to the input file")
     parser.add_argument("-dip", "--declare_in_place", help="Do declarations in place", default=False)
+    parser.add_argument("-oc", "--outline_cold", action="store_true", help="Move error exit branches out of function bodies into cold helpers")
+    parser.add_argument("--instrument", type=lambda modes: modes.split(','), default=[], help=f"Comma separated instrumentation modes: {', '.join(INSTRUMENT_MODES)}")
+    parser.add_argument("--instrument_filter", type=lambda globs: globs.split(','), default=["*"], help="Comma separated Type@method globs selecting the instrumented methods")
+    parser.add_argument("--profile", help="Call count profile written by an --instrument=calls build")
+    parser.add_argument("--bench", action="store_true", help="Replace main with a runner for the @bench methods")
+    parser.add_argument("--dead_code", choices=DEAD_CODE_MODES, default="keep", help="Drop methods and globals unreachable from main and the entry points, or mark them static and unused")
+    parser.add_argument("--entry", type=lambda entries: entries.split(','), default=[], help="Comma separated Type@method entry points kept by --dead_code")
+    parser.add_argument("--visibility", choices=VISIBILITY_MODES, default="default", help="Linkage of methods not marked @export: default, hidden visibility or static")
+    parser.add_argument("--version_script", help="Write a linker version script exporting only the @export methods")
     parser.add_argument("-o", "--output_file", help="Path to the output file (optional)")
     parser.add_argument("-v", "--verbose", action="store_true", help="Enable verbose logging")
     args = parser.parse_args()
 
     setup_logging(args.verbose)
 
+    for mode in args.instrument:
+        if mode not in INSTRUMENT_MODES:
+            logger.error(f"Unknown instrumentation mode '{mode}'.")
+            sys.exit(1)
+
     input_file = args.input_file
     output_file = args.output_file
 
@@ -1053,7 +4772,11 @@ def main():
         with open(input_file, "r") as infile:
             input_lines = infile.readlines()
 
-        transformer = CodeTransformer(input_code,declare_in_place=args.declare_in_place)
+        profile = load_profile(args.profile) if args.profile else None
+        transformer = CodeTransformer(input_code,declare_in_place=args.declare_in_place, outline_cold=args.outline_cold,
+                                      instrument=args.instrument, instrument_filter=args.instrument_filter, profile=profile,
+                                      bench=args.bench, dead_code=args.dead_code, entries=args.entry,
+                                      visibility=args.visibility)
         transformer.run()
 
         with open(output_file, "w") as outfile:
@@ -1061,6 +4784,9 @@ def main():
             outfile.write(f"\n\n///////////////////////////////////////\n")
             outfile.write(f"// {output_file} autogenerated from {input_file}: \n")
             outfile.writelines(["// " + line for line in input_lines])
+        if args.version_script:
+            with open(args.version_script, "w") as scriptfile:
+                scriptfile.write(version_script(transformer.exported_methods, transformer.internal_symbols))
 
         logger.info(f"Transformation completed. Output written to {output_file}")
     except Exception as e:
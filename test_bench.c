@@ -0,0 +1,182 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+typedef struct Accumulator_s Accumulator_t;
+void Accumulator_add(Accumulator_t *self);
+unsigned long Accumulator_sum_squares();
+// Transpile with --bench, run with --samples=5 --min-time=1 --warmup=1
+// The runner replaces main and prints one row for (Accumulator_add) and one for (Accumulator_sum_squares)
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Accumulator_s {
+    unsigned  long total;
+};
+
+// The runner starts from a zero initialized object and only ever adds 3
+void Accumulator_add(Accumulator_t *self) {
+    self->total += 3;
+if(self->total % 3 != 0) abort();
+}
+
+
+
+unsigned long Accumulator_sum_squares() {
+    unsigned long sum = 0;
+for (unsigned long i = 0; i < 64; i++) sum += i * i;
+if(sum != 85344) abort();
+return sum;
+}
+
+
+// Renamed to ns_program_main and never run by the benchmark build; int main( in this comment stays
+int ns_program_main(){
+    return 0;
+}
+typedef struct ns_benchmark {
+    const char *name;
+    void (*run)(void);
+} ns_benchmark;
+static Accumulator_t ns_bench_object_0;
+static void ns_bench_thunk_0(void) {
+    Accumulator_t *ns_self = &ns_bench_object_0;
+    __asm__ volatile("" : "+r"(ns_self) : : "memory");
+    Accumulator_add(ns_self);
+}
+static void ns_bench_thunk_1(void) {
+    unsigned long (*ns_run)(void) = Accumulator_sum_squares;
+    __asm__ volatile("" : "+r"(ns_run));
+    unsigned long ns_result = ns_run();
+    __asm__ volatile("" : : "g"(&ns_result) : "memory");
+}
+static const ns_benchmark ns_benchmarks[] = {
+    {"Accumulator@add", ns_bench_thunk_0},
+    {"Accumulator@sum_squares", ns_bench_thunk_1},
+};
+#define NS_BENCH_COUNT (sizeof ns_benchmarks / sizeof ns_benchmarks[0])
+static uint64_t ns_bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+static uint64_t ns_bench_batch(void (*run)(void), uint64_t iterations) {
+    uint64_t start = ns_bench_now();
+    for (uint64_t i = 0; i < iterations; i++) run();
+    return ns_bench_now() - start;
+}
+static int ns_bench_compare(const void *a, const void *b) {
+    double left = *(const double *)a;
+    double right = *(const double *)b;
+    return (left > right) - (left < right);
+}
+static double ns_bench_percentile(const double *sorted, int count, double percentile) {
+    int index = (int)(percentile / 100.0 * count + 0.999999) - 1;
+    return sorted[index < 0 ? 0 : (index >= count ? count - 1 : index)];
+}
+static int ns_bench_pin(int cpu) {
+#if defined(__linux__)
+    unsigned long mask[16] = {0};
+    if (cpu < 0 || cpu >= (int)(sizeof mask * 8)) return -1;
+    mask[cpu / (8 * sizeof mask[0])] |= 1ul << (cpu % (8 * sizeof mask[0]));
+    return (int)syscall(SYS_sched_setaffinity, 0, sizeof mask, mask);
+#else
+    (void)cpu;
+    return -1;
+#endif
+}
+// Usage: [--filter=text] [--samples=N] [--min-time=ms] [--warmup=ms] [--pin=cpu] [--json]
+static int ns_bench_main(int argc, char **argv) {
+    const char *filter = NULL;
+    int samples = 31;
+    double min_time_ms = 5;
+    double warmup_ms = 100;
+    int json = 0;
+    for (int arg = 1; arg < argc; arg++) {
+        if (!strncmp(argv[arg], "--filter=", 9)) filter = argv[arg] + 9;
+        else if (!strncmp(argv[arg], "--samples=", 10)) samples = atoi(argv[arg] + 10);
+        else if (!strncmp(argv[arg], "--min-time=", 11)) min_time_ms = atof(argv[arg] + 11);
+        else if (!strncmp(argv[arg], "--warmup=", 9)) warmup_ms = atof(argv[arg] + 9);
+        else if (!strncmp(argv[arg], "--pin=", 6)) {
+            if (ns_bench_pin(atoi(argv[arg] + 6)) != 0) fprintf(stderr, "could not pin to cpu %s\n", argv[arg] + 6);
+        }
+        else if (!strcmp(argv[arg], "--json")) json = 1;
+        else {
+            fprintf(stderr, "usage: %s [--filter=text] [--samples=N] [--min-time=ms] [--warmup=ms] [--pin=cpu] [--json]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (samples < 1) samples = 1;
+    double *times = malloc(sizeof(double) * (size_t)samples);
+    if (!times) return 1;
+    const char *separator = "";
+    if (json) printf("{\"benchmarks\":[");
+    else printf("%-32s %12s %12s %12s %12s %12s\n", "benchmark", "iterations", "min ns", "median ns", "p90 ns", "p99 ns");
+    for (size_t index = 0; index < NS_BENCH_COUNT; index++) {
+        const ns_benchmark *benchmark = &ns_benchmarks[index];
+        if (filter && !strstr(benchmark->name, filter)) continue;
+        // Warm up first so the batch size is calibrated against steady state timings
+        uint64_t warmup_end = ns_bench_now() + (uint64_t)(warmup_ms * 1e6);
+        while (ns_bench_now() < warmup_end) ns_bench_batch(benchmark->run, 1);
+        // Then double the batch until one batch fills the minimum sample time
+        uint64_t iterations = 1;
+        uint64_t min_time_ns = (uint64_t)(min_time_ms * 1e6);
+        while (ns_bench_batch(benchmark->run, iterations) < min_time_ns && iterations < (1ull << 40)) iterations *= 2;
+        for (int sample = 0; sample < samples; sample++)
+            times[sample] = (double)ns_bench_batch(benchmark->run, iterations) / (double)iterations;
+        qsort(times, (size_t)samples, sizeof(double), ns_bench_compare);
+        double median = ns_bench_percentile(times, samples, 50);
+        double p90 = ns_bench_percentile(times, samples, 90);
+        double p99 = ns_bench_percentile(times, samples, 99);
+        if (json) {
+            printf("%s\n{\"name\":\"%s\",\"iterations\":%llu,\"samples\":%d,\"min_ns\":%.3f,\"median_ns\":%.3f,\"p90_ns\":%.3f,\"p99_ns\":%.3f,\"max_ns\":%.3f}",
+                   separator, benchmark->name, (unsigned long long)iterations, samples, times[0], median, p90, p99, times[samples - 1]);
+            separator = ",";
+        } else {
+            printf("%-32s %12llu %12.3f %12.3f %12.3f %12.3f\n", benchmark->name, (unsigned long long)iterations, times[0], median, p90, p99);
+        }
+    }
+    if (json) printf("\n]}\n");
+    free(times);
+    return 0;
+}
+int main(int argc, char **argv) {
+    return ns_bench_main(argc, argv);
+}
+
+
+///////////////////////////////////////
+// test_bench.c autogenerated from test_bench.d: 
+// // Transpile with --bench, run with --samples=5 --min-time=1 --warmup=1
+// // The runner replaces main and prints one row for Accumulator@add and one for Accumulator@sum_squares
+// #include <stdio.h>
+// #include <stdlib.h>
+// 
+// struct Accumulator{
+//     unsigned long total;
+// 
+//     // The runner starts from a zero initialized object and only ever adds 3
+//     @bench
+//     void @add(Accumulator *self){
+//         self->total += 3;
+//         if(self->total % 3 != 0) abort();
+//     };
+// 
+//     @bench
+//     unsigned long @sum_squares(){
+//         unsigned long sum = 0;
+//         for (unsigned long i = 0; i < 64; i++) sum += i * i;
+//         if(sum != 85344) abort();
+//         return sum;
+//     };
+// };
+// 
+// // Renamed to ns_program_main and never run by the benchmark build; int main( in this comment stays
+// int main(){
+//     return 0;
+// }
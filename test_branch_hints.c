@@ -0,0 +1,90 @@
+#if defined(__GNUC__) && defined(__ELF__)
+#define NS_HOT __attribute__((hot, section(".text.hot")))
+#define NS_COLD __attribute__((cold, section(".text.unlikely")))
+#elif defined(__GNUC__)
+#define NS_HOT __attribute__((hot))
+#define NS_COLD __attribute__((cold))
+#else
+#define NS_HOT
+#define NS_COLD
+#endif
+#if defined(__GNUC__)
+#define NS_LIKELY(x) __builtin_expect(!!(x), 1)
+#define NS_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define NS_LIKELY(x) (!!(x))
+#define NS_UNLIKELY(x) (!!(x))
+#endif
+typedef struct Account_s Account_t;
+NS_HOT
+int Account_deposit(Account_t *self, int amount);
+NS_COLD
+void Account_report(Account_t *self);
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Account_s {
+     int balance;
+};
+
+
+
+NS_HOT
+int Account_deposit(Account_t *self, int amount) {
+    if(NS_UNLIKELY(amount < 0)) return -1;
+self->balance += amount;
+return self->balance;
+}
+
+
+
+NS_COLD
+void Account_report(Account_t *self) {
+    /* likely(...) in a comment stays as written */
+printf("balance %d, unlikely(%d)\n", self->balance, 0);
+}
+
+
+int main(){
+    Account_t a;
+    a.balance = 0;
+    for (int i = 0; i < 100; i++) {
+        if(NS_LIKELY(Account_deposit(&a, i) >= 0)) continue;
+        Account_report(&a);
+    }
+    if(NS_UNLIKELY((a.balance != 4950))) exit(1);
+    return 0;
+}
+
+///////////////////////////////////////
+// test_branch_hints.c autogenerated from test_branch_hints.d: 
+// #include <stdio.h>
+// #include <stdlib.h>
+// 
+// struct Account{
+//     int balance;
+// 
+//     @hot
+//     int @deposit(Account *self, int amount){
+//         if(unlikely(amount < 0)) return -1;
+//         self->balance += amount;
+//         return self->balance;
+//     };
+// 
+//     @cold
+//     void @report(Account *self){
+//         /* likely(...) in a comment stays as written */
+//         printf("balance %d, unlikely(%d)\n", self->balance, 0);
+//     };
+// };
+// 
+// int main(){
+//     Account a;
+//     a.balance = 0;
+//     for (int i = 0; i < 100; i++) {
+//         if(likely(a@deposit(i) >= 0)) continue;
+//         a@report();
+//     }
+//     if(unlikely((a.balance != 4950))) exit(1);
+//     return 0;
+// }
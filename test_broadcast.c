@@ -0,0 +1,92 @@
+#include <stddef.h>
+#if defined(_OPENMP)
+#define NS_SIMD_LOOP _Pragma("omp simd")
+#elif defined(__clang__)
+#define NS_SIMD_LOOP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define NS_SIMD_LOOP _Pragma("GCC ivdep")
+#else
+#define NS_SIMD_LOOP
+#endif
+typedef struct Particle_s Particle_t;
+void Particle_step(Particle_t *self, float dt);
+void Particle_reset(Particle_t *self);
+#include <stdlib.h>
+
+struct Particle_s {
+     float x;
+     float v;
+};
+
+
+
+void Particle_step(Particle_t *self, float dt) {
+    self->x += self->v * dt;
+}
+
+
+
+void Particle_reset(Particle_t *self) {
+    self->x = 0;
+}
+
+
+int main(){
+    Particle_t particles[64];
+    Particle_t *view = particles;
+    int n = 64;
+    for (int i = 0; i < n; i++) {
+        particles[i].x = 0;
+        particles[i].v = i;
+    }
+    NS_SIMD_LOOP
+    for (ptrdiff_t ns_i0 = (0); ns_i0 < (ptrdiff_t)(n); ns_i0++) Particle_step(&particles[ns_i0], 0.5f);
+    NS_SIMD_LOOP
+    for (ptrdiff_t ns_i1 = (0); ns_i1 < (ptrdiff_t)(n); ns_i1++) Particle_step(&view[ns_i1], 0.5f);
+    for (ptrdiff_t ns_i2 = (0); ns_i2 < (ptrdiff_t)(n); ns_i2++) Particle_reset(&particles[ns_i2]);
+    if(particles[10].x != 0) exit(1);
+    // An empty range with a bound below zero runs no iterations
+    int none = 0;
+    particles[10].x = 1;
+    for (ptrdiff_t ns_i3 = (0); ns_i3 < (ptrdiff_t)(none - 1); ns_i3++) Particle_reset(&particles[ns_i3]);
+    if(particles[10].x != 1) exit(1);
+    return 0;
+}
+
+///////////////////////////////////////
+// test_broadcast.c autogenerated from test_broadcast.d: 
+// #include <stdlib.h>
+// 
+// struct Particle{
+//     float x;
+//     float v;
+// 
+//     @pure
+//     void @step(Particle *self, float dt){
+//         self->x += self->v * dt;
+//     };
+// 
+//     void @reset(Particle *self){
+//         self->x = 0;
+//     };
+// };
+// 
+// int main(){
+//     Particle particles[64];
+//     Particle *view = particles;
+//     int n = 64;
+//     for (int i = 0; i < n; i++) {
+//         particles[i].x = 0;
+//         particles[i].v = i;
+//     }
+//     particles[0..n]@step(0.5f);
+//     view[0..n]@step(0.5f);
+//     particles[0..n]@reset();
+//     if(particles[10].x != 0) exit(1);
+//     // An empty range with a bound below zero runs no iterations
+//     int none = 0;
+//     particles[10].x = 1;
+//     particles[0..none - 1]@reset();
+//     if(particles[10].x != 1) exit(1);
+//     return 0;
+// }
@@ -0,0 +1,102 @@
+#if defined(__GNUC__)
+#define NS_LIKELY(x) __builtin_expect(!!(x), 1)
+#define NS_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define NS_LIKELY(x) (!!(x))
+#define NS_UNLIKELY(x) (!!(x))
+#endif
+#include <stdarg.h>
+#if defined(__GNUC__)
+#define NS_COLD_PATH __attribute__((cold, noinline))
+#define NS_COLD_NORETURN __attribute__((cold, noinline, noreturn))
+#define NS_PRINTF_FORMAT(string_index, first_to_check) __attribute__((__format__(__printf__, string_index, first_to_check)))
+#else
+#define NS_COLD_PATH
+#define NS_COLD_NORETURN
+#define NS_PRINTF_FORMAT(string_index, first_to_check)
+#endif
+typedef struct Buffer_s Buffer_t;
+int Buffer_push(Buffer_t *self, int amount);
+// Transpile with --outline_cold
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Buffer_s {
+     int used;
+     int size;
+};
+
+
+
+NS_COLD_PATH NS_PRINTF_FORMAT(1, 2) static void Buffer_push_cold_0(const char *ns_format, ...) {
+    va_list args;
+    va_start(args, ns_format);
+    vfprintf(stderr, ns_format, args);
+    va_end(args);
+}
+
+int Buffer_push(Buffer_t *self, int amount) {
+    if (NS_UNLIKELY(amount < 0)) return -1;
+if (NS_UNLIKELY(self->used + amount > self->size)) {
+    Buffer_push_cold_0("buffer overflow: %d + %d > %d\n", self->used, amount, self->size);
+    return -1;
+}
+self->used += amount;
+return self->used;
+}
+
+
+NS_COLD_NORETURN static void main_cold_0(void) {
+    exit(1);
+}
+
+NS_COLD_NORETURN static void main_cold_1(void) {
+    fputs("overflow not detected\n", stderr);
+    abort();
+}
+
+int main(){
+    Buffer_t b;
+    b.used = 0;
+    b.size = 10;
+    if (NS_UNLIKELY(Buffer_push(&b, 4) != 4)) main_cold_0();
+    if (NS_UNLIKELY(Buffer_push(&b, 4) != 8)) main_cold_0();
+    if (NS_UNLIKELY(Buffer_push(&b, 4) != -1)) {
+        main_cold_1();
+    }
+    return 0;
+}
+
+///////////////////////////////////////
+// test_cold_paths.c autogenerated from test_cold_paths.d: 
+// // Transpile with --outline_cold
+// #include <stdio.h>
+// #include <stdlib.h>
+// 
+// struct Buffer{
+//     int used;
+//     int size;
+// 
+//     int @push(Buffer *self, int amount){
+//         if(amount < 0) return -1;
+//         if(self->used + amount > self->size) {
+//             fprintf(stderr, "buffer overflow: %d + %d > %d\n", self->used, amount, self->size);
+//             return -1;
+//         }
+//         self->used += amount;
+//         return self->used;
+//     };
+// };
+// 
+// int main(){
+//     Buffer b;
+//     b.used = 0;
+//     b.size = 10;
+//     if(b@push(4) != 4) exit(1);
+//     if(b@push(4) != 8) exit(1);
+//     if(b@push(4) != -1) {
+//         fputs("overflow not detected\n", stderr);
+//         abort();
+//     }
+//     return 0;
+// }
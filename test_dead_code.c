@@ -0,0 +1,98 @@
+typedef struct Counter_s Counter_t;
+typedef struct Counter_globals_s Counter_globals_t;
+void Counter_add(Counter_t *self, int amount);
+int Counter_twice(Counter_t *self);
+typedef struct Orphan_s Orphan_t;
+// Transpile with --dead_code drop: Counter@never, Counter@unused_total and all of Orphan are unreachable from main
+#include <stdio.h>
+
+static int helper(int v){
+    return v * 2;
+}
+
+struct Counter_s {
+     int value;
+};
+
+struct Counter_globals_s {
+     int instances;
+};
+Counter_globals_t Counter_globals;
+
+
+void Counter_add(Counter_t *self, int amount) {
+    self->value += amount;
+(Counter_globals.instances)++;
+}
+
+
+int Counter_twice(Counter_t *self) {
+    return helper(self->value);
+}
+
+
+struct Orphan_s {
+     int x;
+};
+
+
+// Unreachable code that survives clashes with these and fails the build
+int Counter_never;
+int Orphan_touch;
+int Orphan_globals;
+_Static_assert(sizeof(Counter_globals_t) == sizeof(int), "unused_total was kept");
+
+int main(){
+    Counter_t c;
+    c.value = 1;
+    Counter_add(&c, 2);
+    printf("%d %d\n", Counter_twice(&c), (Counter_globals.instances));
+    return 0;
+}
+
+///////////////////////////////////////
+// test_dead_code.c autogenerated from test_dead_code.d: 
+// // Transpile with --dead_code drop: Counter@never, Counter@unused_total and all of Orphan are unreachable from main
+// #include <stdio.h>
+// 
+// static int helper(int v){
+//     return v * 2;
+// }
+// 
+// struct Counter{
+//     int value;
+//     int @instances;
+//     int @unused_total;
+//     void @add(Counter *self, int amount){
+//         self->value += amount;
+//         Counter@instances++;
+//     };
+//     int @twice(Counter *self){
+//         return helper(self->value);
+//     };
+//     void @never(Counter *self){
+//         self->value = 0;
+//     };
+// };
+// 
+// struct Orphan{
+//     int x;
+//     long @hits;
+//     void @touch(Orphan *self){
+//         Orphan@hits += self->x;
+//     };
+// };
+// 
+// // Unreachable code that survives clashes with these and fails the build
+// int Counter_never;
+// int Orphan_touch;
+// int Orphan_globals;
+// _Static_assert(sizeof(Counter_globals_t) == sizeof(int), "unused_total was kept");
+// 
+// int main(){
+//     Counter c;
+//     c.value = 1;
+//     c@add(2);
+//     printf("%d %d\n", c@twice(), Counter@instances);
+//     return 0;
+// }
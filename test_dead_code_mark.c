@@ -0,0 +1,116 @@
+#if defined(__GNUC__)
+#define NS_DEAD_CODE static __attribute__((unused))
+#else
+#define NS_DEAD_CODE static
+#endif
+typedef struct Counter_s Counter_t;
+typedef struct Counter_globals_s Counter_globals_t;
+typedef struct Counter_dead_globals_s Counter_dead_globals_t;
+void Counter_add(Counter_t *self, int amount);
+NS_DEAD_CODE
+void Counter_never(Counter_t *self);
+typedef struct Orphan_s Orphan_t;
+typedef struct Orphan_globals_s Orphan_globals_t;
+NS_DEAD_CODE
+void Orphan_touch(Orphan_t *self);
+// Transpile with --dead_code mark and compile with -Wall -Wextra -Werror: the unreachable members stay
+// in the output as static and unused, and those of a partly used globals struct move to Counter_dead_globals
+#include <stdio.h>
+#if defined(__GNUC__)
+#pragma GCC diagnostic error "-Wunused-function"
+#pragma GCC diagnostic error "-Wunused-variable"
+#endif
+
+struct Counter_s {
+     int value;
+};
+
+struct Counter_globals_s {
+     int instances;
+};
+Counter_globals_t Counter_globals;
+
+struct Counter_dead_globals_s {
+     int unused_total;
+};
+NS_DEAD_CODE Counter_dead_globals_t Counter_dead_globals;
+
+
+void Counter_add(Counter_t *self, int amount) {
+    self->value += amount;
+(Counter_globals.instances)++;
+}
+
+
+NS_DEAD_CODE
+void Counter_never(Counter_t *self) {
+    self->value = 0;
+(Counter_dead_globals.unused_total)++;
+}
+
+
+struct Orphan_s {
+     int x;
+};
+
+struct Orphan_globals_s {
+     long hits;
+};
+NS_DEAD_CODE Orphan_globals_t Orphan_globals;
+
+
+NS_DEAD_CODE
+void Orphan_touch(Orphan_t *self) {
+    (Orphan_globals.hits) += self->x;
+}
+
+
+int main(){
+    Counter_t c;
+    c.value = 1;
+    Counter_add(&c, 2);
+    // Live globals keep their place in Counter_globals
+    printf("%d %d %zu\n", c.value, (Counter_globals.instances), sizeof(Counter_globals_t));
+    return sizeof(Counter_globals_t) == sizeof(int) ? 0 : 1;
+}
+
+///////////////////////////////////////
+// test_dead_code_mark.c autogenerated from test_dead_code_mark.d: 
+// // Transpile with --dead_code mark and compile with -Wall -Wextra -Werror: the unreachable members stay
+// // in the output as static and unused, and those of a partly used globals struct move to Counter_dead_globals
+// #include <stdio.h>
+// #if defined(__GNUC__)
+// #pragma GCC diagnostic error "-Wunused-function"
+// #pragma GCC diagnostic error "-Wunused-variable"
+// #endif
+// 
+// struct Counter{
+//     int value;
+//     int @instances;
+//     int @unused_total;
+//     void @add(Counter *self, int amount){
+//         self->value += amount;
+//         Counter@instances++;
+//     };
+//     void @never(Counter *self){
+//         self->value = 0;
+//         Counter@unused_total++;
+//     };
+// };
+// 
+// struct Orphan{
+//     int x;
+//     long @hits;
+//     void @touch(Orphan *self){
+//         Orphan@hits += self->x;
+//     };
+// };
+// 
+// int main(){
+//     Counter c;
+//     c.value = 1;
+//     c@add(2);
+//     // Live globals keep their place in Counter_globals
+//     printf("%d %d %zu\n", c.value, Counter@instances, sizeof(Counter_globals_t));
+//     return sizeof(Counter_globals_t) == sizeof(int) ? 0 : 1;
+// }
@@ -0,0 +1,82 @@
+#define NS_INTERNAL static
+#if defined(_WIN32)
+#define NS_EXPORT __declspec(dllexport)
+#elif defined(__GNUC__)
+#define NS_EXPORT __attribute__((visibility("default")))
+#else
+#define NS_EXPORT
+#endif
+typedef struct Codec_s Codec_t;
+NS_INTERNAL
+unsigned Codec_mix(Codec_t *self, unsigned value);
+NS_EXPORT
+unsigned Codec_checksum(Codec_t *self, const unsigned char *data, int length);
+// Transpile with --visibility static: only Codec_checksum stays an external symbol
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Codec_s {
+     unsigned seed;
+};
+
+
+
+NS_INTERNAL
+unsigned Codec_mix(Codec_t *self, unsigned value) {
+    return (value ^ self->seed) * 2654435761u;
+}
+
+
+
+NS_EXPORT
+unsigned Codec_checksum(Codec_t *self, const unsigned char *data, int length) {
+    unsigned total = self->seed;
+for (int i = 0; i < length; i++) {
+total = Codec_mix(self, total + data[i]);
+}
+return total;
+}
+
+
+int main(){
+    Codec_t codec;
+    codec.seed = 7;
+    const unsigned char data[] = {1, 2, 3};
+    if(Codec_checksum(&codec, data, 3) != Codec_checksum(&codec, data, 3)) exit(1);
+    if(Codec_checksum(&codec, data, 2) == Codec_checksum(&codec, data, 3)) exit(1);
+    printf("%u\n", Codec_checksum(&codec, data, 3));
+    return 0;
+}
+
+///////////////////////////////////////
+// test_export.c autogenerated from test_export.d: 
+// // Transpile with --visibility static: only Codec_checksum stays an external symbol
+// #include <stdio.h>
+// #include <stdlib.h>
+// 
+// struct Codec{
+//     unsigned seed;
+// 
+//     unsigned @mix(Codec *self, unsigned value){
+//         return (value ^ self->seed) * 2654435761u;
+//     };
+// 
+//     @export
+//     unsigned @checksum(Codec *self, const unsigned char *data, int length){
+//         unsigned total = self->seed;
+//         for (int i = 0; i < length; i++) {
+//             total = Codec@mix(self, total + data[i]);
+//         }
+//         return total;
+//     };
+// };
+// 
+// int main(){
+//     Codec codec;
+//     codec.seed = 7;
+//     const unsigned char data[] = {1, 2, 3};
+//     if(codec@checksum(data, 3) != codec@checksum(data, 3)) exit(1);
+//     if(codec@checksum(data, 2) == codec@checksum(data, 3)) exit(1);
+//     printf("%u\n", codec@checksum(data, 3));
+//     return 0;
+// }
@@ -0,0 +1,139 @@
+#include <stdint.h>
+#include <string.h>
+static inline uint64_t ns_hash_mix(uint64_t hash, uint64_t word) {
+    hash ^= word * 0xbf58476d1ce4e5b9u;
+    return (hash << 27 | hash >> 37) * 0x94d049bb133111ebu;
+}
+static inline uint64_t ns_hash_finish(uint64_t hash) {
+    hash ^= hash >> 31;
+    hash *= 0x7fb5d329728ea185u;
+    hash ^= hash >> 27;
+    hash *= 0x81dadef4bc2dd44du;
+    return hash ^ hash >> 33;
+}
+typedef struct Key_s Key_t;
+uint64_t Key_hash(const Key_t *self);
+int Key_eq(const Key_t *a, const Key_t *b);
+typedef struct Pair_s Pair_t;
+uint64_t Pair_hash(const Pair_t *self);
+int Pair_eq(const Pair_t *a, const Pair_t *b);
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+struct Key_s {
+     uint8_t kind;
+     uint32_t id;
+     char tag[3];
+     double weight;
+     uint16_t port;
+};
+
+uint64_t Key_hash(const Key_t *self) {
+    _Static_assert(sizeof(Key_t) == 32, "unexpected Key layout");
+    const unsigned char *bytes = (const unsigned char *)self;
+    uint64_t hash = 0x9e3779b97f4a7c15u;
+    uint64_t word;
+    word = 0;
+    memcpy(&word, bytes + 0, 1);
+    hash = ns_hash_mix(hash, word);
+    word = 0;
+    memcpy(&word, bytes + 4, 7);
+    hash = ns_hash_mix(hash, word);
+    memcpy(&word, bytes + 16, 8);
+    hash = ns_hash_mix(hash, word);
+    word = 0;
+    memcpy(&word, bytes + 24, 2);
+    hash = ns_hash_mix(hash, word);
+    return ns_hash_finish(hash);
+}
+int Key_eq(const Key_t *a, const Key_t *b) {
+    _Static_assert(sizeof(Key_t) == 32, "unexpected Key layout");
+    return memcmp((const unsigned char *)a + 0, (const unsigned char *)b + 0, 1) == 0 &&
+           memcmp((const unsigned char *)a + 4, (const unsigned char *)b + 4, 7) == 0 &&
+           memcmp((const unsigned char *)a + 16, (const unsigned char *)b + 16, 10) == 0;
+}
+
+
+struct Pair_s {
+     int32_t left;
+     int32_t right;
+};
+
+uint64_t Pair_hash(const Pair_t *self) {
+    _Static_assert(sizeof(Pair_t) == 8, "unexpected Pair layout");
+    const unsigned char *bytes = (const unsigned char *)self;
+    uint64_t hash = 0x9e3779b97f4a7c15u;
+    uint64_t word;
+    memcpy(&word, bytes + 0, 8);
+    hash = ns_hash_mix(hash, word);
+    return ns_hash_finish(hash);
+}
+int Pair_eq(const Pair_t *a, const Pair_t *b) {
+    _Static_assert(sizeof(Pair_t) == 8, "unexpected Pair layout");
+    return memcmp(a, b, sizeof *a) == 0;
+}
+
+
+int main(){
+    Key_t a;
+    Key_t b;
+    memset(&a, 0xaa, sizeof a);
+    memset(&b, 0x55, sizeof b);
+    a.kind = b.kind = 3;
+    a.id = b.id = 77;
+    memcpy(a.tag, "ab", 3);
+    memcpy(b.tag, "ab", 3);
+    a.weight = b.weight = 1.5;
+    a.port = b.port = 8080;
+    printf("%d %d\n", Key_eq(&a, &b), Key_hash(&a) == Key_hash(&b));
+    b.port = 8081;
+    printf("%d %d\n", Key_eq(&a, &b), Key_hash(&a) == Key_hash(&b));
+    Pair_t p;
+    Pair_t q;
+    p.left = 1; p.right = 2;
+    q.left = 2; q.right = 1;
+    printf("%d %d %d\n", Pair_eq(&p, &q), Pair_hash(&p) == Pair_hash(&q), Pair_eq(&p, &p));
+    return 0;
+}
+
+///////////////////////////////////////
+// test_hashable.c autogenerated from test_hashable.d: 
+// #include <stdio.h>
+// #include <stdint.h>
+// #include <string.h>
+// 
+// struct Key @hashable {
+//     uint8_t kind;
+//     uint32_t id;
+//     char tag[3];
+//     double weight;
+//     uint16_t port;
+// };
+// 
+// struct Pair @hashable {
+//     int32_t left;
+//     int32_t right;
+// };
+// 
+// int main(){
+//     Key a;
+//     Key b;
+//     memset(&a, 0xaa, sizeof a);
+//     memset(&b, 0x55, sizeof b);
+//     a.kind = b.kind = 3;
+//     a.id = b.id = 77;
+//     memcpy(a.tag, "ab", 3);
+//     memcpy(b.tag, "ab", 3);
+//     a.weight = b.weight = 1.5;
+//     a.port = b.port = 8080;
+//     printf("%d %d\n", Key_eq(&a, &b), Key_hash(&a) == Key_hash(&b));
+//     b.port = 8081;
+//     printf("%d %d\n", Key_eq(&a, &b), Key_hash(&a) == Key_hash(&b));
+//     Pair p;
+//     Pair q;
+//     p.left = 1; p.right = 2;
+//     q.left = 2; q.right = 1;
+//     printf("%d %d %d\n", Pair_eq(&p, &q), Pair_hash(&p) == Pair_hash(&q), Pair_eq(&p, &p));
+//     return 0;
+// }
@@ -0,0 +1,440 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+static inline char *ns_json_write_u64(char *out, uint64_t value) {
+    static const char pairs[] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839404142434445464748495051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+    char digits[20];
+    char *end = digits + sizeof digits;
+    char *at = end;
+    while (value >= 100) {
+        at -= 2;
+        memcpy(at, pairs + value % 100 * 2, 2);
+        value /= 100;
+    }
+    if (value >= 10) {
+        at -= 2;
+        memcpy(at, pairs + value * 2, 2);
+    } else {
+        *--at = (char)('0' + value);
+    }
+    memcpy(out, at, (size_t)(end - at));
+    return out + (end - at);
+}
+static inline char *ns_json_write_i64(char *out, int64_t value) {
+    if (value < 0) {
+        *out++ = '-';
+        return ns_json_write_u64(out, 0 - (uint64_t)value);
+    }
+    return ns_json_write_u64(out, (uint64_t)value);
+}
+static inline char *ns_json_write_double(char *out, double value, int digits) {
+    if (value != value || value - value != 0) {
+        memcpy(out, "null", 4);
+        return out + 4;
+    }
+    return out + snprintf(out, 32, "%.*g", digits, value);
+}
+static inline char *ns_json_write_bool(char *out, int value) {
+    if (value) {
+        memcpy(out, "true", 4);
+        return out + 4;
+    }
+    memcpy(out, "false", 5);
+    return out + 5;
+}
+static inline char *ns_json_write_string(char *out, const char *text, size_t size) {
+    static const char hex[] = "0123456789abcdef";
+    *out++ = '"';
+    for (size_t i = 0; i < size && text[i]; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c == '"' || c == '\\') {
+            *out++ = '\\';
+            *out++ = (char)c;
+        } else if (c < 0x20) {
+            memcpy(out, "\\u00", 4);
+            out[4] = hex[c >> 4];
+            out[5] = hex[c & 15];
+            out += 6;
+        } else {
+            *out++ = (char)c;
+        }
+    }
+    *out++ = '"';
+    return out;
+}
+typedef struct ns_json_reader_s {
+    const char *at;
+    const char *end;
+} ns_json_reader_t;
+static inline void ns_json_space(ns_json_reader_t *reader) {
+    while (reader->at < reader->end && (*reader->at == ' ' || *reader->at == '\t' || *reader->at == '\n' || *reader->at == '\r')) reader->at++;
+}
+static inline int ns_json_expect(ns_json_reader_t *reader, char c) {
+    ns_json_space(reader);
+    if (reader->at < reader->end && *reader->at == c) {
+        reader->at++;
+        return 1;
+    }
+    return 0;
+}
+static inline int ns_json_read_key(ns_json_reader_t *reader, const char **key, size_t *length) {
+    if (!ns_json_expect(reader, '"')) return 0;
+    *key = reader->at;
+    while (reader->at < reader->end && *reader->at != '"') reader->at += *reader->at == '\\' ? 2 : 1;
+    if (reader->at >= reader->end) return 0;
+    *length = (size_t)(reader->at - *key);
+    reader->at++;
+    return 1;
+}
+static inline int ns_json_read_u64(ns_json_reader_t *reader, uint64_t max, uint64_t *value) {
+    ns_json_space(reader);
+    const char *start = reader->at;
+    uint64_t result = 0;
+    while (reader->at < reader->end && *reader->at >= '0' && *reader->at <= '9') {
+        unsigned digit = (unsigned)(*reader->at++ - '0');
+        if (result > (max - digit) / 10) return 0;
+        result = result * 10 + digit;
+    }
+    *value = result;
+    return reader->at != start;
+}
+static inline int ns_json_read_i64(ns_json_reader_t *reader, int64_t min, int64_t max, int64_t *value) {
+    ns_json_space(reader);
+    uint64_t magnitude;
+    if (reader->at < reader->end && *reader->at == '-') {
+        reader->at++;
+        if (!ns_json_read_u64(reader, 0 - (uint64_t)min, &magnitude)) return 0;
+        *value = magnitude ? -(int64_t)(magnitude - 1) - 1 : 0;
+        return 1;
+    }
+    if (!ns_json_read_u64(reader, (uint64_t)max, &magnitude)) return 0;
+    *value = (int64_t)magnitude;
+    return 1;
+}
+static inline int ns_json_read_double(ns_json_reader_t *reader, double *value) {
+    char number[64];
+    size_t length = 0;
+    ns_json_space(reader);
+    if (reader->end - reader->at >= 4 && memcmp(reader->at, "null", 4) == 0) {
+        reader->at += 4;
+        *value = NAN;
+        return 1;
+    }
+    while (reader->at < reader->end && length < sizeof number - 1 && strchr("+-.0123456789eE", *reader->at)) number[length++] = *reader->at++;
+    number[length] = '\0';
+    char *parsed;
+    *value = strtod(number, &parsed);
+    return length && parsed == number + length;
+}
+static inline int ns_json_read_bool(ns_json_reader_t *reader, int *value) {
+    ns_json_space(reader);
+    if (reader->end - reader->at >= 4 && memcmp(reader->at, "true", 4) == 0) {
+        reader->at += 4;
+        *value = 1;
+        return 1;
+    }
+    if (reader->end - reader->at >= 5 && memcmp(reader->at, "false", 5) == 0) {
+        reader->at += 5;
+        *value = 0;
+        return 1;
+    }
+    return 0;
+}
+static inline int ns_json_read_string(ns_json_reader_t *reader, char *out, size_t size) {
+    size_t length = 0;
+    if (!ns_json_expect(reader, '"')) return 0;
+    while (reader->at < reader->end && *reader->at != '"') {
+        char c = *reader->at++;
+        if (c == '\\') {
+            if (reader->at >= reader->end) return 0;
+            c = *reader->at++;
+            switch (c) {
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'n': c = '\n'; break;
+            case 'r': c = '\r'; break;
+            case 't': c = '\t'; break;
+            case 'u': {
+                if (reader->end - reader->at < 4) return 0;
+                char hex[5] = { reader->at[0], reader->at[1], reader->at[2], reader->at[3], '\0' };
+                char *parsed;
+                unsigned long code = strtoul(hex, &parsed, 16);
+                if (parsed != hex + 4 || code > 0x7f) return 0;
+                c = (char)code;
+                reader->at += 4;
+                break;
+            }
+            }
+        }
+        if (length >= size) return 0;
+        out[length++] = c;
+    }
+    if (reader->at >= reader->end) return 0;
+    reader->at++;
+    // A string filling all size bytes has no terminator, as the writer allows
+    memset(out + length, 0, size - length);
+    return 1;
+}
+static inline int ns_json_skip(ns_json_reader_t *reader, int depth) {
+    ns_json_space(reader);
+    if (reader->at >= reader->end || depth > 64) return 0;
+    char open = *reader->at;
+    if (open == '"') {
+        const char *key;
+        size_t length;
+        return ns_json_read_key(reader, &key, &length);
+    }
+    if (open == '{' || open == '[') {
+        char close = open == '{' ? '}' : ']';
+        reader->at++;
+        if (ns_json_expect(reader, close)) return 1;
+        do {
+            if (open == '{') {
+                const char *key;
+                size_t length;
+                if (!ns_json_read_key(reader, &key, &length) || !ns_json_expect(reader, ':')) return 0;
+            }
+            if (!ns_json_skip(reader, depth + 1)) return 0;
+        } while (ns_json_expect(reader, ','));
+        return ns_json_expect(reader, close);
+    }
+    const char *start = reader->at;
+    while (reader->at < reader->end && !strchr(",}] \t\r\n", *reader->at)) reader->at++;
+    return reader->at != start;
+}
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+static inline uint32_t ns_fnv1a(const char *key, size_t length, uint32_t seed) {
+    for (size_t i = 0; i < length; i++) seed = (seed ^ (unsigned char)key[i]) * 0x01000193u;
+    return seed;
+}
+typedef struct Order_s Order_t;
+size_t Order_to_json(const Order_t *self, char *buffer, size_t capacity);
+int Order_from_json(Order_t *out, const char *json, size_t length);
+int Order_total(Order_t *self);
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+struct Order_s {
+     int64_t id;
+     uint32_t quantity;
+     int16_t delta;
+     double price;
+     float ratio;
+     bool urgent;
+     char symbol[8];
+     int32_t legs[3];
+};
+
+#define Order_JSON_MAX_SIZE 269u
+static int Order_json_field(const char *name, size_t length) {
+    static const uint32_t seeds[8] = { 1u, 528u, 4u, 1u, 0u, 0u, 6u, 4u };
+    static const char *const names[8] = { "ratio", "quantity", "price", "legs", "delta", "id", "urgent", "symbol" };
+    static const uint32_t lengths[8] = { 5, 8, 5, 4, 5, 2, 6, 6 };
+    static const int indexes[8] = { 4, 1, 3, 7, 2, 0, 5, 6 };
+    uint32_t bucket = (uint32_t)((uint64_t)ns_fnv1a(name, length, 0x811c9dc5u) * 8u >> 32);
+    uint32_t slot = (uint32_t)((uint64_t)ns_fnv1a(name, length, seeds[bucket]) * 8u >> 32);
+    if (lengths[slot] != length || memcmp(names[slot], name, length) != 0) return -1;
+    return indexes[slot];
+}
+size_t Order_to_json(const Order_t *self, char *buffer, size_t capacity) {
+    if (capacity < Order_JSON_MAX_SIZE) return 0;
+    char *p = buffer;
+    memcpy(p, "{\"id\":", 6);
+    p += 6;
+    p = ns_json_write_i64(p, self->id);
+    memcpy(p, ",\"quantity\":", 12);
+    p += 12;
+    p = ns_json_write_u64(p, self->quantity);
+    memcpy(p, ",\"delta\":", 9);
+    p += 9;
+    p = ns_json_write_i64(p, self->delta);
+    memcpy(p, ",\"price\":", 9);
+    p += 9;
+    p = ns_json_write_double(p, self->price, 17);
+    memcpy(p, ",\"ratio\":", 9);
+    p += 9;
+    p = ns_json_write_double(p, self->ratio, 9);
+    memcpy(p, ",\"urgent\":", 10);
+    p += 10;
+    p = ns_json_write_bool(p, self->urgent);
+    memcpy(p, ",\"symbol\":", 10);
+    p += 10;
+    p = ns_json_write_string(p, self->symbol, 8);
+    memcpy(p, ",\"legs\":", 8);
+    p += 8;
+    *p++ = '[';
+    for (size_t ns_k = 0; ns_k < 3; ns_k++) {
+        if (ns_k) *p++ = ',';
+        p = ns_json_write_i64(p, self->legs[ns_k]);
+    }
+    *p++ = ']';
+    *p++ = '}';
+    *p = '\0';
+    return (size_t)(p - buffer);
+}
+int Order_from_json(Order_t *out, const char *json, size_t length) {
+    ns_json_reader_t reader = { json, json + length };
+    if (!ns_json_expect(&reader, '{')) return -1;
+    int more = !ns_json_expect(&reader, '}');
+    while (more) {
+        const char *key;
+        size_t key_length;
+        if (!ns_json_read_key(&reader, &key, &key_length) || !ns_json_expect(&reader, ':')) return -1;
+        switch (Order_json_field(key, key_length)) {
+        case 0: {
+            int64_t value;
+            if (!ns_json_read_i64(&reader, -9223372036854775807LL - 1, 9223372036854775807LL, &value)) return -1;
+            out->id = (int64_t)value;
+            break;
+        }
+        case 1: {
+            uint64_t value;
+            if (!ns_json_read_u64(&reader, 4294967295ULL, &value)) return -1;
+            out->quantity = (uint32_t)value;
+            break;
+        }
+        case 2: {
+            int64_t value;
+            if (!ns_json_read_i64(&reader, -32767LL - 1, 32767LL, &value)) return -1;
+            out->delta = (int16_t)value;
+            break;
+        }
+        case 3: {
+            double value;
+            if (!ns_json_read_double(&reader, &value)) return -1;
+            out->price = (double)value;
+            break;
+        }
+        case 4: {
+            double value;
+            if (!ns_json_read_double(&reader, &value)) return -1;
+            out->ratio = (float)value;
+            break;
+        }
+        case 5: {
+            int value;
+            if (!ns_json_read_bool(&reader, &value)) return -1;
+            out->urgent = value;
+            break;
+        }
+        case 6: {
+            if (!ns_json_read_string(&reader, out->symbol, 8)) return -1;
+            break;
+        }
+        case 7: {
+            if (!ns_json_expect(&reader, '[')) return -1;
+            for (size_t ns_k = 0; ns_k < 3; ns_k++) {
+                if (ns_k && !ns_json_expect(&reader, ',')) return -1;
+                int64_t value;
+                if (!ns_json_read_i64(&reader, -2147483647LL - 1, 2147483647LL, &value)) return -1;
+                out->legs[ns_k] = (int32_t)value;
+            }
+            if (!ns_json_expect(&reader, ']')) return -1;
+            break;
+        }
+        default:
+            if (!ns_json_skip(&reader, 0)) return -1;
+        }
+        more = ns_json_expect(&reader, ',');
+        if (!more && !ns_json_expect(&reader, '}')) return -1;
+    }
+    ns_json_space(&reader);
+    return reader.at == reader.end ? 0 : -1;
+}
+
+
+int Order_total(Order_t *self) {
+    return self->legs[0] + self->legs[1] + self->legs[2];
+}
+
+
+int main(){
+    Order_t o;
+    memset(&o, 0, sizeof o);
+    o.id = -9223372036854775807LL - 1;
+    o.quantity = 4294967295u;
+    o.delta = -12;
+    o.price = 101.25;
+    o.ratio = 0.5f;
+    o.urgent = true;
+    strcpy(o.symbol, "A\"B\\\n");
+    o.legs[0] = 1; o.legs[1] = -2; o.legs[2] = 30;
+    char buffer[Order_JSON_MAX_SIZE];
+    size_t length = Order_to_json(&o, buffer, sizeof buffer);
+    printf("%zu %s\n", length, buffer);
+    Order_t d;
+    memset(&d, 0, sizeof d);
+    printf("%d\n", Order_from_json(&d, buffer, length));
+    printf("%d %lld %u %d %g %g %d %d\n", memcmp(d.symbol, o.symbol, 8), (long long)d.id, d.quantity, d.delta, d.price, d.ratio, d.urgent, Order_total(&d));
+    const char *text = " { \"unknown\": {\"a\": [1, \"x\", {}]}, \"quantity\" : 7 , \"symbol\":\"XY\\u0041\", \"legs\":[4,5,6] } ";
+    int status = Order_from_json(&d, text, strlen(text));
+    printf("%d %u %s %d\n", status, d.quantity, d.symbol, Order_total(&d));
+    // A symbol using all 8 bytes has no terminator and must survive a round trip
+    memcpy(o.symbol, "ABCDEFGH", 8);
+    length = Order_to_json(&o, buffer, sizeof buffer);
+    memset(&d, 0, sizeof d);
+    status = Order_from_json(&d, buffer, length);
+    printf("%d %d %.8s\n", status, memcmp(d.symbol, o.symbol, 8), d.symbol);
+    text = "{\"symbol\": \"ABCDEFGHI\"}";
+    printf("%d\n", Order_from_json(&d, text, strlen(text)));
+    printf("%d %d %d\n", Order_from_json(&d, "{\"quantity\": 4294967296}", 24), Order_from_json(&d, "{}", 2), Order_from_json(&d, "{\"delta\": 1.5}", 14));
+    return 0;
+}
+
+///////////////////////////////////////
+// test_json.c autogenerated from test_json.d: 
+// #include <stdio.h>
+// #include <string.h>
+// #include <stdbool.h>
+// 
+// struct Order @json {
+//     int64_t id;
+//     uint32_t quantity;
+//     int16_t delta;
+//     double price;
+//     float ratio;
+//     bool urgent;
+//     char symbol[8];
+//     int32_t legs[3];
+//     int @total(Order *self){
+//         return self->legs[0] + self->legs[1] + self->legs[2];
+//     };
+// };
+// 
+// int main(){
+//     Order o;
+//     memset(&o, 0, sizeof o);
+//     o.id = -9223372036854775807LL - 1;
+//     o.quantity = 4294967295u;
+//     o.delta = -12;
+//     o.price = 101.25;
+//     o.ratio = 0.5f;
+//     o.urgent = true;
+//     strcpy(o.symbol, "A\"B\\\n");
+//     o.legs[0] = 1; o.legs[1] = -2; o.legs[2] = 30;
+//     char buffer[Order_JSON_MAX_SIZE];
+//     size_t length = Order_to_json(&o, buffer, sizeof buffer);
+//     printf("%zu %s\n", length, buffer);
+//     Order d;
+//     memset(&d, 0, sizeof d);
+//     printf("%d\n", Order_from_json(&d, buffer, length));
+//     printf("%d %lld %u %d %g %g %d %d\n", memcmp(d.symbol, o.symbol, 8), (long long)d.id, d.quantity, d.delta, d.price, d.ratio, d.urgent, d@total());
+//     const char *text = " { \"unknown\": {\"a\": [1, \"x\", {}]}, \"quantity\" : 7 , \"symbol\":\"XY\\u0041\", \"legs\":[4,5,6] } ";
+//     int status = Order_from_json(&d, text, strlen(text));
+//     printf("%d %u %s %d\n", status, d.quantity, d.symbol, d@total());
+//     // A symbol using all 8 bytes has no terminator and must survive a round trip
+//     memcpy(o.symbol, "ABCDEFGH", 8);
+//     length = Order_to_json(&o, buffer, sizeof buffer);
+//     memset(&d, 0, sizeof d);
+//     status = Order_from_json(&d, buffer, length);
+//     printf("%d %d %.8s\n", status, memcmp(d.symbol, o.symbol, 8), d.symbol);
+//     text = "{\"symbol\": \"ABCDEFGHI\"}";
+//     printf("%d\n", Order_from_json(&d, text, strlen(text)));
+//     printf("%d %d %d\n", Order_from_json(&d, "{\"quantity\": 4294967296}", 24), Order_from_json(&d, "{}", 2), Order_from_json(&d, "{\"delta\": 1.5}", 14));
+//     return 0;
+// }
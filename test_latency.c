@@ -0,0 +1,254 @@
+#define NS_METHOD_COUNT 2
+static const char *const ns_method_names[NS_METHOD_COUNT] = {
+    "Work@wait_us",
+    "Work@quick",
+};
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(NS_LATENCY_RDTSC) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define NS_LATENCY_NOW() ((uint64_t)__rdtsc())
+#else
+static inline uint64_t ns_latency_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#define NS_LATENCY_NOW() ns_latency_now()
+#endif
+// Log-linear buckets: exact below 16, then 8 sub-buckets per power of two
+#define NS_LATENCY_BUCKETS 496
+typedef struct ns_latency_histogram {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint64_t buckets[NS_LATENCY_BUCKETS];
+} ns_latency_histogram;
+// Each thread records into its own block; blocks are never freed so snapshots can always walk them
+typedef struct ns_latency_block {
+    struct ns_latency_block *next;
+    ns_latency_histogram methods[NS_METHOD_COUNT];
+} ns_latency_block;
+static ns_latency_block *ns_latency_blocks;
+static __thread ns_latency_block *ns_latency_local;
+static inline unsigned ns_latency_bucket(uint64_t value) {
+    if (value < 16) return (unsigned)value;
+    unsigned exponent = 63 - (unsigned)__builtin_clzll(value);
+    return 16 + (exponent - 4) * 8 + (unsigned)((value >> (exponent - 3)) & 7);
+}
+static inline uint64_t ns_latency_bucket_limit(unsigned bucket) {
+    if (bucket < 16) return bucket;
+    unsigned exponent = (bucket - 16) / 8 + 4;
+    uint64_t sub = (bucket - 16) % 8;
+    return ((9 + sub) << (exponent - 3)) - 1;
+}
+static ns_latency_block *ns_latency_thread_block(void) {
+    ns_latency_block *block = calloc(1, sizeof *block);
+    if (!block) return NULL;
+    block->next = __atomic_load_n(&ns_latency_blocks, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&ns_latency_blocks, &block->next, block, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    ns_latency_local = block;
+    return block;
+}
+// Only the owning thread writes; relaxed atomics keep concurrent snapshots and resets well defined
+#define NS_LATENCY_ADD(field, value) __atomic_store_n(&(field), __atomic_load_n(&(field), __ATOMIC_RELAXED) + (value), __ATOMIC_RELAXED)
+static inline void ns_latency_record(int id, uint64_t elapsed) {
+    ns_latency_block *block = ns_latency_local;
+    if (__builtin_expect(!block, 0) && !(block = ns_latency_thread_block())) return;
+    ns_latency_histogram *histogram = &block->methods[id];
+    NS_LATENCY_ADD(histogram->buckets[ns_latency_bucket(elapsed)], 1);
+    NS_LATENCY_ADD(histogram->count, 1);
+    NS_LATENCY_ADD(histogram->sum, elapsed);
+    if (elapsed > __atomic_load_n(&histogram->max, __ATOMIC_RELAXED))
+        __atomic_store_n(&histogram->max, elapsed, __ATOMIC_RELAXED);
+}
+// Sums every thread's histograms into out, which holds NS_METHOD_COUNT entries indexed like ns_method_names
+__attribute__((unused)) static void ns_latency_snapshot(ns_latency_histogram *out) {
+    memset(out, 0, sizeof(ns_latency_histogram) * NS_METHOD_COUNT);
+    for (ns_latency_block *block = __atomic_load_n(&ns_latency_blocks, __ATOMIC_ACQUIRE); block; block = block->next) {
+        for (int id = 0; id < NS_METHOD_COUNT; id++) {
+            ns_latency_histogram *histogram = &block->methods[id];
+            for (int bucket = 0; bucket < NS_LATENCY_BUCKETS; bucket++)
+                out[id].buckets[bucket] += __atomic_load_n(&histogram->buckets[bucket], __ATOMIC_RELAXED);
+            out[id].count += __atomic_load_n(&histogram->count, __ATOMIC_RELAXED);
+            out[id].sum += __atomic_load_n(&histogram->sum, __ATOMIC_RELAXED);
+            uint64_t max = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+            if (max > out[id].max) out[id].max = max;
+        }
+    }
+}
+// Samples recorded while a reset runs may survive it
+__attribute__((unused)) static void ns_latency_reset(void) {
+    for (ns_latency_block *block = __atomic_load_n(&ns_latency_blocks, __ATOMIC_ACQUIRE); block; block = block->next) {
+        for (int id = 0; id < NS_METHOD_COUNT; id++) {
+            ns_latency_histogram *histogram = &block->methods[id];
+            for (int bucket = 0; bucket < NS_LATENCY_BUCKETS; bucket++)
+                __atomic_store_n(&histogram->buckets[bucket], 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&histogram->count, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&histogram->sum, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&histogram->max, 0, __ATOMIC_RELAXED);
+        }
+    }
+}
+// Upper bound of the bucket holding the given percentile (0-100), clamped to the recorded maximum
+__attribute__((unused)) static uint64_t ns_latency_percentile(const ns_latency_histogram *histogram, double percentile) {
+    if (!histogram->count) return 0;
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)histogram->count + 0.5);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (unsigned bucket = 0; bucket < NS_LATENCY_BUCKETS; bucket++) {
+        seen += histogram->buckets[bucket];
+        if (seen >= rank) {
+            uint64_t limit = ns_latency_bucket_limit(bucket);
+            return limit < histogram->max ? limit : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+__attribute__((unused)) static void ns_latency_report(FILE *out) {
+    ns_latency_histogram *snapshot = malloc(sizeof(ns_latency_histogram) * NS_METHOD_COUNT);
+    if (!snapshot) return;
+    ns_latency_snapshot(snapshot);
+    fprintf(out, "%-32s %12s %12s %12s %12s %12s %12s\n", "method", "count", "mean", "p50", "p90", "p99", "max");
+    for (int id = 0; id < NS_METHOD_COUNT; id++) {
+        const ns_latency_histogram *histogram = &snapshot[id];
+        if (!histogram->count) continue;
+        fprintf(out, "%-32s %12llu %12llu %12llu %12llu %12llu %12llu\n", ns_method_names[id],
+                (unsigned long long)histogram->count,
+                (unsigned long long)(histogram->sum / histogram->count),
+                (unsigned long long)ns_latency_percentile(histogram, 50),
+                (unsigned long long)ns_latency_percentile(histogram, 90),
+                (unsigned long long)ns_latency_percentile(histogram, 99),
+                (unsigned long long)histogram->max);
+    }
+    free(snapshot);
+}
+typedef struct Work_s Work_t;
+void Work_wait_us(Work_t *self, long micros);
+int Work_quick(Work_t *self);
+// Transpile with --instrument latency
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+struct Work_s {
+     long spins;
+};
+
+// Busy waits for at least the given number of microseconds
+static inline void Work_wait_us__body(Work_t *self, long micros) {
+    struct timespec start, now;
+clock_gettime(CLOCK_MONOTONIC, &start);
+do {
+self->spins++;
+clock_gettime(CLOCK_MONOTONIC, &now);
+} while((now.tv_sec - start.tv_sec) * 1000000000L + (now.tv_nsec - start.tv_nsec) < micros * 1000L);
+}
+void Work_wait_us(Work_t *self, long micros) {
+    uint64_t ns_latency_start = NS_LATENCY_NOW();
+    Work_wait_us__body(self, micros);
+    ns_latency_record(0, NS_LATENCY_NOW() - ns_latency_start);
+}
+
+
+
+static inline int Work_quick__body(Work_t *self) {
+    return (int)(self->spins & 1);
+}
+int Work_quick(Work_t *self) {
+    uint64_t ns_latency_start = NS_LATENCY_NOW();
+    int ns_result = Work_quick__body(self);
+    ns_latency_record(1, NS_LATENCY_NOW() - ns_latency_start);
+    return ns_result;
+}
+
+
+int main(){
+    Work_t w;
+    w.spins = 0;
+    for (int i = 0; i < 20; i++) Work_wait_us(&w, 200);
+    for (int i = 0; i < 1000; i++) Work_quick(&w);
+    // Every bucket's limit is the largest value it holds
+    for (uint64_t value = 0; value < 100000; value += 7) {
+        unsigned bucket = ns_latency_bucket(value);
+        if(value > ns_latency_bucket_limit(bucket)) exit(1);
+        if(bucket > 0 && value <= ns_latency_bucket_limit(bucket - 1)) exit(1);
+    }
+    ns_latency_histogram snapshot[NS_METHOD_COUNT];
+    ns_latency_snapshot(snapshot);
+    uint64_t counts[2] = {0, 0};
+    for (int id = 0; id < NS_METHOD_COUNT; id++) {
+        uint64_t in_buckets = 0;
+        for (int bucket = 0; bucket < NS_LATENCY_BUCKETS; bucket++) in_buckets += snapshot[id].buckets[bucket];
+        if(in_buckets != snapshot[id].count) exit(1);
+        if(ns_latency_percentile(&snapshot[id], 99) > snapshot[id].max) exit(1);
+        counts[id] = snapshot[id].count;
+    }
+    // Methods are numbered in declaration order
+    if(counts[0] != 20 || counts[1] != 1000) exit(1);
+    if(ns_latency_percentile(&snapshot[0], 50) < 200000 || snapshot[0].sum < 20 * 200000) exit(1);
+    ns_latency_reset();
+    ns_latency_snapshot(snapshot);
+    if(snapshot[0].count != 0 || snapshot[1].max != 0) exit(1);
+    printf("%llu %llu\n", (unsigned long long)counts[0], (unsigned long long)counts[1]);
+    return 0;
+}
+
+///////////////////////////////////////
+// test_latency.c autogenerated from test_latency.d: 
+// // Transpile with --instrument latency
+// #include <stdio.h>
+// #include <stdlib.h>
+// #include <time.h>
+// 
+// struct Work{
+//     long spins;
+// 
+//     // Busy waits for at least the given number of microseconds
+//     void @wait_us(Work *self, long micros){
+//         struct timespec start, now;
+//         clock_gettime(CLOCK_MONOTONIC, &start);
+//         do {
+//             self->spins++;
+//             clock_gettime(CLOCK_MONOTONIC, &now);
+//         } while((now.tv_sec - start.tv_sec) * 1000000000L + (now.tv_nsec - start.tv_nsec) < micros * 1000L);
+//     };
+// 
+//     int @quick(Work *self){
+//         return (int)(self->spins & 1);
+//     };
+// };
+// 
+// int main(){
+//     Work w;
+//     w.spins = 0;
+//     for (int i = 0; i < 20; i++) w@wait_us(200);
+//     for (int i = 0; i < 1000; i++) w@quick();
+//     // Every bucket's limit is the largest value it holds
+//     for (uint64_t value = 0; value < 100000; value += 7) {
+//         unsigned bucket = ns_latency_bucket(value);
+//         if(value > ns_latency_bucket_limit(bucket)) exit(1);
+//         if(bucket > 0 && value <= ns_latency_bucket_limit(bucket - 1)) exit(1);
+//     }
+//     ns_latency_histogram snapshot[NS_METHOD_COUNT];
+//     ns_latency_snapshot(snapshot);
+//     uint64_t counts[2] = {0, 0};
+//     for (int id = 0; id < NS_METHOD_COUNT; id++) {
+//         uint64_t in_buckets = 0;
+//         for (int bucket = 0; bucket < NS_LATENCY_BUCKETS; bucket++) in_buckets += snapshot[id].buckets[bucket];
+//         if(in_buckets != snapshot[id].count) exit(1);
+//         if(ns_latency_percentile(&snapshot[id], 99) > snapshot[id].max) exit(1);
+//         counts[id] = snapshot[id].count;
+//     }
+//     // Methods are numbered in declaration order
+//     if(counts[0] != 20 || counts[1] != 1000) exit(1);
+//     if(ns_latency_percentile(&snapshot[0], 50) < 200000 || snapshot[0].sum < 20 * 200000) exit(1);
+//     ns_latency_reset();
+//     ns_latency_snapshot(snapshot);
+//     if(snapshot[0].count != 0 || snapshot[1].max != 0) exit(1);
+//     printf("%llu %llu\n", (unsigned long long)counts[0], (unsigned long long)counts[1]);
+//     return 0;
+// }
@@ -0,0 +1,170 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+static inline uint32_t ns_fnv1a(const char *key, size_t length, uint32_t seed) {
+    for (size_t i = 0; i < length; i++) seed = (seed ^ (unsigned char)key[i]) * 0x01000193u;
+    return seed;
+}
+typedef struct Account_s Account_t;
+int Account_find_method(const char *name, size_t length);
+int Account_find_field(const char *name, size_t length);
+int Account_deposit(Account_t *self, int amount);
+int Account_withdraw(Account_t *self, int amount);
+int Account_freeze(Account_t *self, int amount);
+int Account_audit(Account_t *self, int amount);
+typedef struct Empty_s Empty_t;
+int Empty_find_method(const char *name, size_t length);
+int Empty_find_field(const char *name, size_t length);
+#include <stdio.h>
+#include <string.h>
+
+struct Account_s {
+     long balance;
+     int frozen;
+};
+
+enum Account_method_index_e {
+    Account_METHOD_deposit,
+    Account_METHOD_withdraw,
+    Account_METHOD_freeze,
+    Account_METHOD_audit,
+};
+int Account_find_method(const char *name, size_t length) {
+    static const uint32_t seeds[4] = { 1u, 1u, 0u, 3u };
+    static const char *const names[4] = { "deposit", "withdraw", "freeze", "audit" };
+    static const uint32_t lengths[4] = { 7, 8, 6, 5 };
+    static const int indexes[4] = { 0, 1, 2, 3 };
+    uint32_t bucket = (uint32_t)((uint64_t)ns_fnv1a(name, length, 0x811c9dc5u) * 4u >> 32);
+    uint32_t slot = (uint32_t)((uint64_t)ns_fnv1a(name, length, seeds[bucket]) * 4u >> 32);
+    if (lengths[slot] != length || memcmp(names[slot], name, length) != 0) return -1;
+    return indexes[slot];
+}
+enum Account_field_index_e {
+    Account_FIELD_balance,
+    Account_FIELD_frozen,
+};
+int Account_find_field(const char *name, size_t length) {
+    static const uint32_t seeds[2] = { 1u, 1u };
+    static const char *const names[2] = { "balance", "frozen" };
+    static const uint32_t lengths[2] = { 7, 6 };
+    static const int indexes[2] = { 0, 1 };
+    uint32_t bucket = (uint32_t)((uint64_t)ns_fnv1a(name, length, 0x811c9dc5u) * 2u >> 32);
+    uint32_t slot = (uint32_t)((uint64_t)ns_fnv1a(name, length, seeds[bucket]) * 2u >> 32);
+    if (lengths[slot] != length || memcmp(names[slot], name, length) != 0) return -1;
+    return indexes[slot];
+}
+
+
+int Account_deposit(Account_t *self, int amount) {
+    self->balance += amount;
+return 0;
+}
+
+
+int Account_withdraw(Account_t *self, int amount) {
+    self->balance -= amount;
+return 0;
+}
+
+
+int Account_freeze(Account_t *self, int amount) {
+    self->frozen = amount;
+return 0;
+}
+
+
+int Account_audit(Account_t *self, int amount) {
+    return (int)self->balance + amount;
+}
+
+
+struct Empty_s {
+     int value;
+};
+
+int Empty_find_method(const char *name, size_t length) {
+    (void)name;
+    (void)length;
+    return -1;
+}
+enum Empty_field_index_e {
+    Empty_FIELD_value,
+};
+int Empty_find_field(const char *name, size_t length) {
+    static const uint32_t seeds[1] = { 1u };
+    static const char *const names[1] = { "value" };
+    static const uint32_t lengths[1] = { 5 };
+    static const int indexes[1] = { 0 };
+    uint32_t bucket = (uint32_t)((uint64_t)ns_fnv1a(name, length, 0x811c9dc5u) * 1u >> 32);
+    uint32_t slot = (uint32_t)((uint64_t)ns_fnv1a(name, length, seeds[bucket]) * 1u >> 32);
+    if (lengths[slot] != length || memcmp(names[slot], name, length) != 0) return -1;
+    return indexes[slot];
+}
+
+
+int main(){
+    Account_t a;
+    a.balance = 0;
+    a.frozen = 0;
+    const char *commands[] = {"deposit", "withdraw", "audit", "audi", "auditx", "freeze"};
+    int amounts[] = {50, 8, 0, 0, 0, 1};
+    for (int i = 0; i < 6; i++) {
+        int index = Account_find_method(commands[i], strlen(commands[i]));
+        int result = -1;
+        if (index == Account_METHOD_deposit) result = Account_deposit(&a, amounts[i]);
+        if (index == Account_METHOD_withdraw) result = Account_withdraw(&a, amounts[i]);
+        if (index == Account_METHOD_freeze) result = Account_freeze(&a, amounts[i]);
+        if (index == Account_METHOD_audit) result = Account_audit(&a, amounts[i]);
+        printf("%s %d %d\n", commands[i], index, result);
+    }
+    printf("%d %d %d %d %d\n", a.frozen, Account_find_field("frozen", 6), Account_find_field("balance", 7), Empty_find_method("x", 1), Empty_find_field("value", 5));
+    return 0;
+}
+
+///////////////////////////////////////
+// test_lookup.c autogenerated from test_lookup.d: 
+// #include <stdio.h>
+// #include <string.h>
+// 
+// struct Account {
+//     long balance;
+//     int frozen;
+//     int @deposit(Account *self, int amount){
+//         self->balance += amount;
+//         return 0;
+//     };
+//     int @withdraw(Account *self, int amount){
+//         self->balance -= amount;
+//         return 0;
+//     };
+//     int @freeze(Account *self, int amount){
+//         self->frozen = amount;
+//         return 0;
+//     };
+//     int @audit(Account *self, int amount){
+//         return (int)self->balance + amount;
+//     };
+// };
+// 
+// struct Empty @lookup {
+//     int value;
+// };
+// 
+// int main(){
+//     Account a;
+//     a.balance = 0;
+//     a.frozen = 0;
+//     const char *commands[] = {"deposit", "withdraw", "audit", "audi", "auditx", "freeze"};
+//     int amounts[] = {50, 8, 0, 0, 0, 1};
+//     for (int i = 0; i < 6; i++) {
+//         int index = Account_find_method(commands[i], strlen(commands[i]));
+//         int result = -1;
+//         if (index == Account_METHOD_deposit) result = a@deposit(amounts[i]);
+//         if (index == Account_METHOD_withdraw) result = a@withdraw(amounts[i]);
+//         if (index == Account_METHOD_freeze) result = a@freeze(amounts[i]);
+//         if (index == Account_METHOD_audit) result = a@audit(amounts[i]);
+//         printf("%s %d %d\n", commands[i], index, result);
+//     }
+//     printf("%d %d %d %d %d\n", a.frozen, Account_find_field("frozen", 6), Account_find_field("balance", 7), Empty_find_method("x", 1), Empty_find_field("value", 5));
+//     return 0;
+// }
@@ -1,4 +1,8 @@
 typedef struct Space_s Space_t;
+int Space_alone(Space_t *self);
+int Space_together(Space_t *self, Space_t *other);
+int Space_switched(Space_t *other, Space_t *self);
+Empty_t Empty_nothing(Empty_t *self);
 struct Space_s {
      int a;
 };
@@ -22,6 +26,17 @@ int Space_switched(Space_t *other, Space_t *self) {
 }
 
 
+// TODO @(dleiferives,094df03c-85fe-439c-8ac2-582c7918eb9a): Figure out what to do
+// if a struct with no member values uses itself. ~#
+// IDEA @(dleiferives,44a0007d-8ca0-4e32-a673-22400b3e7be6): Could just make a
+// struct with no members. if that does not compile then its possible to just add
+// one. ~#
+
+Empty_t Empty_nothing(Empty_t *self) {
+    return *self;
+}
+
+
 int main(){
     Space_t the_final_frontier;
     Space_t is_cold;
@@ -29,6 +44,15 @@ int main(){
     is_cold.a = 30;
     if(Space_alone(&the_final_frontier) != 20) exit(1);
     if(Space_together(&is_cold, &the_final_frontier) != 30) exit(1);
+    // TODO @(dleiferives,25bce2d9-851f-4557-8892-dca625b5843d): add compiler
+    // errors for when number of arguments passed does not align with arguments
+    // used ~#
+    // TODO @(dleiferives,83f65d32-7687-49eb-8294-28dd7a71e12d): emacs todo remove
+    // org mode addition for note, info, make answer have to be on a question.
+    // adds to the org mode entry for the question and marks it answered or
+    // something. removde duplication of text ~#
+    // NOTE @(dleiferives,16ad7ac7-86d9-460d-946a-dc465cf2c085): This is intended
+    // to error ~#
     if(Space_switched(&the_final_frontier) != 20) exit(1);
 
     return 0;
@@ -54,6 +78,17 @@ int main(){
 // 
 // };
 // 
+// // TODO @(dleiferives,094df03c-85fe-439c-8ac2-582c7918eb9a): Figure out what to do
+// // if a struct with no member values uses itself. ~#
+// // IDEA @(dleiferives,44a0007d-8ca0-4e32-a673-22400b3e7be6): Could just make a
+// // struct with no members. if that does not compile then its possible to just add
+// // one. ~#
+// struct Empty{
+//     Empty @nothing(Empty *self){
+//         return *self;
+//     };
+// }
+// 
 // int main(){
 //     Space the_final_frontier;
 //     Space is_cold;
@@ -61,6 +96,15 @@ int main(){
 //     is_cold.a = 30;
 //     if(the_final_frontier@alone() != 20) exit(1);
 //     if(is_cold@together(&the_final_frontier) != 30) exit(1);
+//     // TODO @(dleiferives,25bce2d9-851f-4557-8892-dca625b5843d): add compiler
+//     // errors for when number of arguments passed does not align with arguments
+//     // used ~#
+//     // TODO @(dleiferives,83f65d32-7687-49eb-8294-28dd7a71e12d): emacs todo remove
+//     // org mode addition for note, info, make answer have to be on a question.
+//     // adds to the org mode entry for the question and marks it answered or
+//     // something. removde duplication of text ~#
+//     // NOTE @(dleiferives,16ad7ac7-86d9-460d-946a-dc465cf2c085): This is intended
+//     // to error ~#
 //     if(is_cold@switched(&the_final_frontier) != 20) exit(1);
 // 
 //     return 0;
@@ -1,3 +1,4 @@
+int Goomba_member();
 
 int Goomba_member() {
     return 10;
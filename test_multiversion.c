@@ -0,0 +1,68 @@
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__ELF__)
+#define NS_TARGET_CLONES(...) __attribute__((target_clones(__VA_ARGS__)))
+#else
+#define NS_TARGET_CLONES(...)
+#endif
+typedef struct Vector_s Vector_t;
+NS_TARGET_CLONES("default", "avx2", "arch=x86-64-v4")
+float Vector_sum(Vector_t *self);
+NS_TARGET_CLONES("default", "sse4.2")
+void Vector_scale(Vector_t *self, float factor);
+#include <stdio.h>
+
+struct Vector_s {
+     float data[256];
+};
+
+// Cloned per target, picked at load time by the CPU's features
+NS_TARGET_CLONES("default", "avx2", "arch=x86-64-v4")
+float Vector_sum(Vector_t *self) {
+    float total = 0;
+for (int i = 0; i < 256; i++) total += self->data[i];
+return total;
+}
+
+// The default clone is added when it is not listed
+NS_TARGET_CLONES("default", "sse4.2")
+void Vector_scale(Vector_t *self, float factor) {
+    for (int i = 0; i < 256; i++) self->data[i] *= factor;
+}
+
+
+int main(){
+    Vector_t v;
+    for (int i = 0; i < 256; i++) v.data[i] = 1.0f;
+    Vector_scale(&v, 2.0f);
+    printf("%g\n", Vector_sum(&v));
+    return 0;
+}
+
+///////////////////////////////////////
+// test_multiversion.c autogenerated from test_multiversion.d: 
+// #include <stdio.h>
+// 
+// struct Vector{
+//     float data[256];
+// 
+//     // Cloned per target, picked at load time by the CPU's features
+//     @multiversion("avx2", "arch=x86-64-v4")
+//     float @sum(Vector *self){
+//         float total = 0;
+//         for (int i = 0; i < 256; i++) total += self->data[i];
+//         return total;
+//     };
+// 
+//     // The default clone is added when it is not listed
+//     @multiversion(default, "sse4.2")
+//     void @scale(Vector *self, float factor){
+//         for (int i = 0; i < 256; i++) self->data[i] *= factor;
+//     };
+// };
+// 
+// int main(){
+//     Vector v;
+//     for (int i = 0; i < 256; i++) v.data[i] = 1.0f;
+//     v@scale(2.0f);
+//     printf("%g\n", v@sum());
+//     return 0;
+// }
@@ -0,0 +1,246 @@
+#define NS_METHOD_COUNT 2
+static const char *const ns_method_names[NS_METHOD_COUNT] = {
+    "Matrix@sum_rows",
+    "Matrix@sum_columns",
+};
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__linux__)
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#define NS_PERF_COUNTERS 5
+static const char *const ns_perf_counter_names[NS_PERF_COUNTERS] = {
+    "cycles", "instructions", "l1d-misses", "llc-misses", "branch-misses",
+};
+// Counter values plus the time the group was enabled and actually running on the PMU
+typedef struct ns_perf_sample {
+    uint64_t values[NS_PERF_COUNTERS];
+    uint64_t enabled;
+    uint64_t running;
+} ns_perf_sample;
+// Per thread totals; blocks are never freed so reports can always walk them
+typedef struct ns_perf_block {
+    struct ns_perf_block *next;
+    uint64_t calls[NS_METHOD_COUNT];
+    // Calls whose counters were multiplexed with other events and scaled up to estimates
+    uint64_t scaled[NS_METHOD_COUNT];
+    uint64_t totals[NS_METHOD_COUNT][NS_PERF_COUNTERS];
+} ns_perf_block;
+static ns_perf_block *ns_perf_blocks;
+static int ns_perf_error;
+// Group leader fd, -2 before the thread opened its counters and -1 when they are unavailable
+static __thread int ns_perf_fd = -2;
+// Position of each counter in the group read, -1 for counters the kernel refused
+static __thread int ns_perf_slot[NS_PERF_COUNTERS];
+static __thread ns_perf_block *ns_perf_local;
+#if defined(__linux__)
+static int ns_perf_open_counter(uint32_t type, uint64_t config, int group) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof attr);
+    attr.size = sizeof attr;
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+static void ns_perf_open(void) {
+    static const uint32_t types[NS_PERF_COUNTERS] = {
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+    };
+    static const uint64_t configs[NS_PERF_COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+    };
+    ns_perf_fd = ns_perf_open_counter(types[0], configs[0], -1);
+    if (ns_perf_fd < 0) {
+        __atomic_store_n(&ns_perf_error, errno, __ATOMIC_RELAXED);
+        ns_perf_fd = -1;
+        return;
+    }
+    int slot = 0;
+    ns_perf_slot[0] = slot++;
+    for (int counter = 1; counter < NS_PERF_COUNTERS; counter++) {
+        int fd = ns_perf_open_counter(types[counter], configs[counter], ns_perf_fd);
+        ns_perf_slot[counter] = fd < 0 ? -1 : slot++;
+    }
+    ioctl(ns_perf_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+#endif
+static inline void ns_perf_read(ns_perf_sample *sample) {
+    memset(sample, 0, sizeof *sample);
+#if defined(__linux__)
+    if (__builtin_expect(ns_perf_fd == -2, 0)) ns_perf_open();
+    if (ns_perf_fd < 0) return;
+    // Layout: counter count, time enabled, time running, then one value per counter
+    uint64_t group[3 + NS_PERF_COUNTERS];
+    if (read(ns_perf_fd, group, sizeof group) < (ssize_t)(3 * sizeof(uint64_t))) return;
+    sample->enabled = group[1];
+    sample->running = group[2];
+    for (int counter = 0; counter < NS_PERF_COUNTERS; counter++)
+        if (ns_perf_slot[counter] >= 0 && (uint64_t)ns_perf_slot[counter] < group[0])
+            sample->values[counter] = group[3 + ns_perf_slot[counter]];
+#endif
+}
+static ns_perf_block *ns_perf_thread_block(void) {
+    ns_perf_block *block = calloc(1, sizeof *block);
+    if (!block) return NULL;
+    block->next = __atomic_load_n(&ns_perf_blocks, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&ns_perf_blocks, &block->next, block, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    ns_perf_local = block;
+    return block;
+}
+// Only the owning thread writes; relaxed atomics keep concurrent reports well defined
+#define NS_PERF_ADD(field, value) __atomic_store_n(&(field), __atomic_load_n(&(field), __ATOMIC_RELAXED) + (value), __ATOMIC_RELAXED)
+static inline void ns_perf_record(int id, const ns_perf_sample *start) {
+    ns_perf_sample end;
+    ns_perf_read(&end);
+    ns_perf_block *block = ns_perf_local;
+    if (__builtin_expect(!block, 0) && !(block = ns_perf_thread_block())) return;
+    NS_PERF_ADD(block->calls[id], 1);
+    // A group that shared the PMU only counted for part of the call; extrapolate to the enabled time
+    uint64_t enabled = end.enabled - start->enabled;
+    uint64_t running = end.running - start->running;
+    int multiplexed = running < enabled;
+    if (multiplexed) NS_PERF_ADD(block->scaled[id], 1);
+    for (int counter = 0; counter < NS_PERF_COUNTERS; counter++) {
+        uint64_t delta = end.values[counter] - start->values[counter];
+        if (multiplexed && running) delta = (uint64_t)((double)delta * (double)enabled / (double)running);
+        NS_PERF_ADD(block->totals[id][counter], delta);
+    }
+}
+// Prints per method totals summed over all threads, counters include nested calls; rows with
+// multiplexed calls are estimates and are flagged with how many calls were scaled
+__attribute__((unused)) static void ns_perf_report(FILE *out) {
+    int error = __atomic_load_n(&ns_perf_error, __ATOMIC_RELAXED);
+    if (error) fprintf(out, "hardware counters unavailable (%s), only call counts are exact\n", strerror(error));
+    fprintf(out, "%-32s %12s", "method", "calls");
+    for (int counter = 0; counter < NS_PERF_COUNTERS; counter++) fprintf(out, " %14s", ns_perf_counter_names[counter]);
+    fprintf(out, "\n");
+    for (int id = 0; id < NS_METHOD_COUNT; id++) {
+        uint64_t calls = 0;
+        uint64_t scaled = 0;
+        uint64_t totals[NS_PERF_COUNTERS] = {0};
+        for (ns_perf_block *block = __atomic_load_n(&ns_perf_blocks, __ATOMIC_ACQUIRE); block; block = block->next) {
+            calls += __atomic_load_n(&block->calls[id], __ATOMIC_RELAXED);
+            scaled += __atomic_load_n(&block->scaled[id], __ATOMIC_RELAXED);
+            for (int counter = 0; counter < NS_PERF_COUNTERS; counter++)
+                totals[counter] += __atomic_load_n(&block->totals[id][counter], __ATOMIC_RELAXED);
+        }
+        if (!calls) continue;
+        fprintf(out, "%-32s %12llu", ns_method_names[id], (unsigned long long)calls);
+        for (int counter = 0; counter < NS_PERF_COUNTERS; counter++) fprintf(out, " %14llu", (unsigned long long)totals[counter]);
+        if (scaled) fprintf(out, "  (estimated: %llu calls multiplexed)", (unsigned long long)scaled);
+        fprintf(out, "\n");
+    }
+}
+typedef struct Matrix_s Matrix_t;
+double Matrix_sum_rows(Matrix_t *self);
+double Matrix_sum_columns(Matrix_t *self);
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Matrix_s {
+     int n;
+     double *cells;
+};
+
+
+
+static inline double Matrix_sum_rows__body(Matrix_t *self) {
+    double total = 0;
+for (int i = 0; i < self->n; i++)
+for (int j = 0; j < self->n; j++)
+total += self->cells[i * self->n + j];
+return total;
+}
+double Matrix_sum_rows(Matrix_t *self) {
+    ns_perf_sample ns_perf_start;
+    ns_perf_read(&ns_perf_start);
+    double ns_result = Matrix_sum_rows__body(self);
+    ns_perf_record(0, &ns_perf_start);
+    return ns_result;
+}
+
+
+
+static inline double Matrix_sum_columns__body(Matrix_t *self) {
+    double total = 0;
+for (int j = 0; j < self->n; j++)
+for (int i = 0; i < self->n; i++)
+total += self->cells[i * self->n + j];
+return total;
+}
+double Matrix_sum_columns(Matrix_t *self) {
+    ns_perf_sample ns_perf_start;
+    ns_perf_read(&ns_perf_start);
+    double ns_result = Matrix_sum_columns__body(self);
+    ns_perf_record(1, &ns_perf_start);
+    return ns_result;
+}
+
+
+int main(){
+    Matrix_t m;
+    m.n = 512;
+    m.cells = calloc(m.n * m.n, sizeof(double));
+    if(!m.cells) exit(1);
+    for (int i = 0; i < m.n * m.n; i++) m.cells[i] = i % 7;
+    for (int round = 0; round < 10; round++) {
+        if(Matrix_sum_rows(&m) != Matrix_sum_columns(&m)) exit(1);
+    }
+    ns_perf_report(stdout);
+    free(m.cells);
+    return 0;
+}
+
+///////////////////////////////////////
+// test_perfcount.c autogenerated from test_perfcount.d: 
+// #include <stdio.h>
+// #include <stdlib.h>
+// 
+// struct Matrix{
+//     int n;
+//     double *cells;
+// 
+//     @perfcount
+//     double @sum_rows(Matrix *self){
+//         double total = 0;
+//         for (int i = 0; i < self->n; i++)
+//             for (int j = 0; j < self->n; j++)
+//                 total += self->cells[i * self->n + j];
+//         return total;
+//     };
+// 
+//     @perfcount
+//     double @sum_columns(Matrix *self){
+//         double total = 0;
+//         for (int j = 0; j < self->n; j++)
+//             for (int i = 0; i < self->n; i++)
+//                 total += self->cells[i * self->n + j];
+//         return total;
+//     };
+// };
+// 
+// int main(){
+//     Matrix m;
+//     m.n = 512;
+//     m.cells = calloc(m.n * m.n, sizeof(double));
+//     if(!m.cells) exit(1);
+//     for (int i = 0; i < m.n * m.n; i++) m.cells[i] = i % 7;
+//     for (int round = 0; round < 10; round++) {
+//         if(m@sum_rows() != m@sum_columns()) exit(1);
+//     }
+//     ns_perf_report(stdout);
+//     free(m.cells);
+//     return 0;
+// }
@@ -0,0 +1,149 @@
+#define NS_METHOD_COUNT 3
+static const char *const ns_method_names[NS_METHOD_COUNT] = {
+    "Parser@next_token",
+    "Parser@parse_number",
+    "Parser@report_error",
+};
+#include <stdio.h>
+#include <stdlib.h>
+static unsigned long long ns_call_counts[NS_METHOD_COUNT];
+#define NS_COUNT_CALL(id) __atomic_fetch_add(&ns_call_counts[id], 1, __ATOMIC_RELAXED)
+__attribute__((destructor)) static void ns_call_counts_dump(void) {
+    const char *path = getenv("NS_PROFILE_OUT");
+    FILE *out = fopen(path ? path : "ns_profile.txt", "a");
+    if (!out) return;
+    for (int i = 0; i < NS_METHOD_COUNT; i++)
+        fprintf(out, "%s %llu\n", ns_method_names[i], ns_call_counts[i]);
+    fclose(out);
+}
+#if defined(__GNUC__) && defined(__ELF__)
+#define NS_HOT __attribute__((hot, section(".text.hot")))
+#define NS_COLD __attribute__((cold, section(".text.unlikely")))
+#elif defined(__GNUC__)
+#define NS_HOT __attribute__((hot))
+#define NS_COLD __attribute__((cold))
+#else
+#define NS_HOT
+#define NS_COLD
+#endif
+typedef struct Parser_s Parser_t;
+NS_HOT
+int Parser_next_token(Parser_t *self);
+int Parser_parse_number(Parser_t *self, int first);
+NS_COLD
+void Parser_report_error(Parser_t *self);
+// Transpile with --instrument calls --profile test_profile.prof
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct Parser_s {
+    const  char *at;
+};
+
+
+
+NS_HOT
+int Parser_next_token(Parser_t *self) {
+    NS_COUNT_CALL(0);
+    while(*self->at == ' ') self->at++;
+return *self->at ? *self->at++ : 0;
+}
+
+
+
+int Parser_parse_number(Parser_t *self, int first) {
+    NS_COUNT_CALL(1);
+    int value = first - '0';
+while(*self->at >= '0' && *self->at <= '9') value = value * 10 + (*self->at++ - '0');
+return value;
+}
+
+
+
+NS_COLD
+void Parser_report_error(Parser_t *self) {
+    NS_COUNT_CALL(2);
+    fprintf(stderr, "unexpected text at '%s'\n", self->at);
+}
+
+
+// The profile made the busiest method hot and the never called one cold
+#if defined(__GNUC__) && __GNUC__ >= 9 && !defined(__clang__)
+_Static_assert(__builtin_has_attribute(Parser_next_token, hot), "next_token is not hot");
+_Static_assert(__builtin_has_attribute(Parser_report_error, cold), "report_error is not cold");
+#endif
+
+static unsigned long long calls_of(const char *name){
+    for (int id = 0; id < NS_METHOD_COUNT; id++)
+        if(!strcmp(ns_method_names[id], name)) return ns_call_counts[id];
+    exit(1);
+}
+
+int main(){
+    Parser_t p;
+    p.at = "12 7 345";
+    int sum = 0;
+    int c;
+    while((c = Parser_next_token(&p))) sum += Parser_parse_number(&p, c);
+    if(sum != 364) exit(1);
+    // The names are split so the transpiler leaves these strings alone
+    if(calls_of("Parser" "@next_token") != 4 || calls_of("Parser" "@parse_number") != 3 || calls_of("Parser" "@report_error") != 0) exit(1);
+    printf("%d\n", sum);
+    // The exit dump would append this run to the profile
+    setenv("NS_PROFILE_OUT", "/dev/null", 1);
+    return 0;
+}
+
+///////////////////////////////////////
+// test_profile.c autogenerated from test_profile.d: 
+// // Transpile with --instrument calls --profile test_profile.prof
+// #include <stdio.h>
+// #include <stdlib.h>
+// #include <string.h>
+// 
+// struct Parser{
+//     const char *at;
+// 
+//     int @next_token(Parser *self){
+//         while(*self->at == ' ') self->at++;
+//         return *self->at ? *self->at++ : 0;
+//     };
+// 
+//     int @parse_number(Parser *self, int first){
+//         int value = first - '0';
+//         while(*self->at >= '0' && *self->at <= '9') value = value * 10 + (*self->at++ - '0');
+//         return value;
+//     };
+// 
+//     void @report_error(Parser *self){
+//         fprintf(stderr, "unexpected text at '%s'\n", self->at);
+//     };
+// };
+// 
+// // The profile made the busiest method hot and the never called one cold
+// #if defined(__GNUC__) && __GNUC__ >= 9 && !defined(__clang__)
+// _Static_assert(__builtin_has_attribute(Parser_next_token, hot), "next_token is not hot");
+// _Static_assert(__builtin_has_attribute(Parser_report_error, cold), "report_error is not cold");
+// #endif
+// 
+// static unsigned long long calls_of(const char *name){
+//     for (int id = 0; id < NS_METHOD_COUNT; id++)
+//         if(!strcmp(ns_method_names[id], name)) return ns_call_counts[id];
+//     exit(1);
+// }
+// 
+// int main(){
+//     Parser p;
+//     p.at = "12 7 345";
+//     int sum = 0;
+//     int c;
+//     while((c = p@next_token())) sum += p@parse_number(c);
+//     if(sum != 364) exit(1);
+//     // The names are split so the transpiler leaves these strings alone
+//     if(calls_of("Parser" "@next_token") != 4 || calls_of("Parser" "@parse_number") != 3 || calls_of("Parser" "@report_error") != 0) exit(1);
+//     printf("%d\n", sum);
+//     // The exit dump would append this run to the profile
+//     setenv("NS_PROFILE_OUT", "/dev/null", 1);
+//     return 0;
+// }
@@ -0,0 +1,101 @@
+#include <stddef.h>
+typedef enum ns_type_code_e {
+    NS_TYPE_OTHER,
+    NS_TYPE_BOOL,
+    NS_TYPE_CHAR,
+    NS_TYPE_INT,
+    NS_TYPE_UINT,
+    NS_TYPE_FLOAT,
+    NS_TYPE_STRUCT
+} ns_type_code_t;
+typedef struct ns_field_s {
+    const char *name;
+    const char *type_name;
+    size_t offset;
+    size_t size;
+    size_t count;
+    ns_type_code_t type;
+    int ptr_level;
+} ns_field_t;
+typedef struct Vec_s Vec_t;
+static const ns_field_t Vec_fields[2];
+typedef struct Body_s Body_t;
+static const ns_field_t Body_fields[7];
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+struct Vec_s {
+     float x;
+     float y;
+};
+
+#define Vec_FIELD_COUNT 2
+static const ns_field_t Vec_fields[2] = {
+    { "x", "float", offsetof(Vec_t, x), sizeof(((Vec_t *)0)->x), 1, NS_TYPE_FLOAT, 0 },
+    { "y", "float", offsetof(Vec_t, y), sizeof(((Vec_t *)0)->y), 1, NS_TYPE_FLOAT, 0 },
+};
+
+
+struct Body_s {
+     char name[12];
+     Vec_t position;
+    unsigned  int mass;
+     int64_t delta;
+     bool active;
+    const  char *label;
+     double history[4];
+};
+
+#define Body_FIELD_COUNT 7
+static const ns_field_t Body_fields[7] = {
+    { "name", "char", offsetof(Body_t, name), sizeof(((Body_t *)0)->name), sizeof(((Body_t *)0)->name) / sizeof(((Body_t *)0)->name[0]), NS_TYPE_CHAR, 0 },
+    { "position", "Vec_t", offsetof(Body_t, position), sizeof(((Body_t *)0)->position), 1, NS_TYPE_STRUCT, 0 },
+    { "mass", "unsigned int", offsetof(Body_t, mass), sizeof(((Body_t *)0)->mass), 1, NS_TYPE_UINT, 0 },
+    { "delta", "int64_t", offsetof(Body_t, delta), sizeof(((Body_t *)0)->delta), 1, NS_TYPE_INT, 0 },
+    { "active", "bool", offsetof(Body_t, active), sizeof(((Body_t *)0)->active), 1, NS_TYPE_BOOL, 0 },
+    { "label", "const char *", offsetof(Body_t, label), sizeof(((Body_t *)0)->label), 1, NS_TYPE_CHAR, 1 },
+    { "history", "double", offsetof(Body_t, history), sizeof(((Body_t *)0)->history), sizeof(((Body_t *)0)->history) / sizeof(((Body_t *)0)->history[0]), NS_TYPE_FLOAT, 0 },
+};
+
+
+int main(){
+    Body_t b;
+    for (size_t i = 0; i < Body_FIELD_COUNT; i++) {
+        const ns_field_t *f = &Body_fields[i];
+        printf("%s %s %zu %zu %zu %d %d\n", f->name, f->type_name, f->offset, f->size, f->count, f->type, f->ptr_level);
+    }
+    printf("%zu %s %zu\n", (size_t)Vec_FIELD_COUNT, Vec_fields[1].name, sizeof b);
+    return 0;
+}
+
+///////////////////////////////////////
+// test_reflect.c autogenerated from test_reflect.d: 
+// #include <stdio.h>
+// #include <stdbool.h>
+// #include <stdint.h>
+// 
+// struct Vec @reflect {
+//     float x;
+//     float y;
+// };
+// 
+// struct Body {
+//     char name[12];
+//     Vec position;
+//     unsigned int mass;
+//     int64_t delta;
+//     bool active;
+//     const char *label;
+//     double history[4];
+// };
+// 
+// int main(){
+//     Body b;
+//     for (size_t i = 0; i < Body@field_count; i++) {
+//         const ns_field_t *f = &Body@fields[i];
+//         printf("%s %s %zu %zu %zu %d %d\n", f->name, f->type_name, f->offset, f->size, f->count, f->type, f->ptr_level);
+//     }
+//     printf("%zu %s %zu\n", (size_t)Vec_FIELD_COUNT, Vec_fields[1].name, sizeof b);
+//     return 0;
+// }
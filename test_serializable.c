@@ -0,0 +1,227 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define NS_HOST_BIG_ENDIAN 1
+#else
+#define NS_HOST_BIG_ENDIAN 0
+#endif
+#if defined(__GNUC__)
+#define NS_PACKED __attribute__((packed))
+#define NS_BSWAP16(x) __builtin_bswap16(x)
+#define NS_BSWAP32(x) __builtin_bswap32(x)
+#define NS_BSWAP64(x) __builtin_bswap64(x)
+#else
+#define NS_PACKED
+#define NS_BSWAP16(x) ((uint16_t)((uint16_t)(x) >> 8 | (uint16_t)(x) << 8))
+#define NS_BSWAP32(x) ((uint32_t)NS_BSWAP16((uint16_t)(x)) << 16 | NS_BSWAP16((uint16_t)((x) >> 16)))
+#define NS_BSWAP64(x) ((uint64_t)NS_BSWAP32((uint32_t)(x)) << 32 | NS_BSWAP32((uint32_t)((x) >> 32)))
+#endif
+static inline float ns_bswap_float(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof bits);
+    bits = NS_BSWAP32(bits);
+    memcpy(&value, &bits, sizeof bits);
+    return value;
+}
+static inline double ns_bswap_double(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof bits);
+    bits = NS_BSWAP64(bits);
+    memcpy(&value, &bits, sizeof bits);
+    return value;
+}
+#if NS_HOST_BIG_ENDIAN
+#define NS_LE16(x) NS_BSWAP16(x)
+#define NS_LE32(x) NS_BSWAP32(x)
+#define NS_LE64(x) NS_BSWAP64(x)
+#else
+#define NS_LE16(x) (x)
+#define NS_LE32(x) (x)
+#define NS_LE64(x) (x)
+#endif
+typedef struct Reading_s Reading_t;
+typedef struct Reading_view_s Reading_view_t;
+size_t Reading_serialize(const Reading_t *self, void *buffer, size_t capacity);
+int Reading_view(Reading_view_t *view, const void *buffer, size_t size);
+typedef struct Point_s Point_t;
+typedef struct Point_view_s Point_view_t;
+size_t Point_serialize(const Point_t *self, void *buffer, size_t capacity);
+int Point_view(Point_view_t *view, const void *buffer, size_t size);
+#include <stdio.h>
+
+struct Reading_s {
+     uint8_t sensor;
+     uint16_t channel;
+     uint32_t seq;
+     uint8_t tag[3];
+     double value;
+};
+
+// Schema: uint8_t sensor;uint16_t channel;uint32_t seq;uint8_t tag[3];double value
+#define Reading_SCHEMA_HASH 0xdf5ea4b6u
+#define Reading_SERIALIZED_SIZE 32u
+struct Reading_view_s {
+    const unsigned char *data;
+};
+static inline uint8_t Reading_view_sensor(Reading_view_t view) {
+    uint8_t value;
+    memcpy(&value, view.data + 8, 1);
+    return value;
+}
+static inline uint16_t Reading_view_channel(Reading_view_t view) {
+    uint16_t value;
+    uint16_t ns_bits;
+    memcpy(&ns_bits, view.data + 10, 2);
+    ns_bits = NS_LE16(ns_bits);
+    memcpy(&value, &ns_bits, 2);
+    return value;
+}
+static inline uint32_t Reading_view_seq(Reading_view_t view) {
+    uint32_t value;
+    uint32_t ns_bits;
+    memcpy(&ns_bits, view.data + 12, 4);
+    ns_bits = NS_LE32(ns_bits);
+    memcpy(&value, &ns_bits, 4);
+    return value;
+}
+static inline uint8_t Reading_view_tag(Reading_view_t view, size_t ns_k) {
+    uint8_t value;
+    memcpy(&value, view.data + 16 + ns_k * 1, 1);
+    return value;
+}
+static inline double Reading_view_value(Reading_view_t view) {
+    double value;
+    uint64_t ns_bits;
+    memcpy(&ns_bits, view.data + 24, 8);
+    ns_bits = NS_LE64(ns_bits);
+    memcpy(&value, &ns_bits, 8);
+    return value;
+}
+size_t Reading_serialize(const Reading_t *self, void *buffer, size_t capacity) {
+    // Offsets and sizes follow the LP64 layout, which ILP32 and LLP64 targets do not share
+    _Static_assert(sizeof(Reading_t) == 24, "unexpected Reading layout");
+    unsigned char *data = (unsigned char *)buffer;
+    if (capacity < Reading_SERIALIZED_SIZE) return 0;
+    uint32_t ns_header[2] = { NS_LE32(Reading_SCHEMA_HASH), NS_LE32(24u) };
+    memcpy(data, ns_header, sizeof ns_header);
+    memset(data + 8, 0, 24);
+    memcpy(data + 8, &self->sensor, 1);
+    { uint16_t ns_bits; memcpy(&ns_bits, &self->channel, 2); ns_bits = NS_LE16(ns_bits); memcpy(data + 10, &ns_bits, 2); }
+    { uint32_t ns_bits; memcpy(&ns_bits, &self->seq, 4); ns_bits = NS_LE32(ns_bits); memcpy(data + 12, &ns_bits, 4); }
+    for (size_t ns_k = 0; ns_k < 3; ns_k++) memcpy(data + 16 + ns_k, self->tag + ns_k, 1);
+    { uint64_t ns_bits; memcpy(&ns_bits, &self->value, 8); ns_bits = NS_LE64(ns_bits); memcpy(data + 24, &ns_bits, 8); }
+    return Reading_SERIALIZED_SIZE;
+}
+int Reading_view(Reading_view_t *view, const void *buffer, size_t size) {
+    uint32_t ns_header[2];
+    if (size < Reading_SERIALIZED_SIZE) return -1;
+    memcpy(ns_header, buffer, sizeof ns_header);
+    if (NS_LE32(ns_header[0]) != Reading_SCHEMA_HASH || NS_LE32(ns_header[1]) != 24u) return -1;
+    view->data = (const unsigned char *)buffer;
+    return 0;
+}
+
+
+struct Point_s {
+     int32_t x;
+     int32_t y;
+};
+
+// Schema: int32_t x;int32_t y
+#define Point_SCHEMA_HASH 0x95d5cc0fu
+#define Point_SERIALIZED_SIZE 16u
+struct Point_view_s {
+    const unsigned char *data;
+};
+static inline int32_t Point_view_x(Point_view_t view) {
+    int32_t value;
+    uint32_t ns_bits;
+    memcpy(&ns_bits, view.data + 8, 4);
+    ns_bits = NS_LE32(ns_bits);
+    memcpy(&value, &ns_bits, 4);
+    return value;
+}
+static inline int32_t Point_view_y(Point_view_t view) {
+    int32_t value;
+    uint32_t ns_bits;
+    memcpy(&ns_bits, view.data + 12, 4);
+    ns_bits = NS_LE32(ns_bits);
+    memcpy(&value, &ns_bits, 4);
+    return value;
+}
+size_t Point_serialize(const Point_t *self, void *buffer, size_t capacity) {
+    // Offsets and sizes follow the LP64 layout, which ILP32 and LLP64 targets do not share
+    _Static_assert(sizeof(Point_t) == 8, "unexpected Point layout");
+    unsigned char *data = (unsigned char *)buffer;
+    if (capacity < Point_SERIALIZED_SIZE) return 0;
+    uint32_t ns_header[2] = { NS_LE32(Point_SCHEMA_HASH), NS_LE32(8u) };
+    memcpy(data, ns_header, sizeof ns_header);
+#if NS_HOST_BIG_ENDIAN
+    { uint32_t ns_bits; memcpy(&ns_bits, &self->x, 4); ns_bits = NS_LE32(ns_bits); memcpy(data + 8, &ns_bits, 4); }
+    { uint32_t ns_bits; memcpy(&ns_bits, &self->y, 4); ns_bits = NS_LE32(ns_bits); memcpy(data + 12, &ns_bits, 4); }
+#else
+    memcpy(data + 8, self, sizeof *self);
+#endif
+    return Point_SERIALIZED_SIZE;
+}
+int Point_view(Point_view_t *view, const void *buffer, size_t size) {
+    uint32_t ns_header[2];
+    if (size < Point_SERIALIZED_SIZE) return -1;
+    memcpy(ns_header, buffer, sizeof ns_header);
+    if (NS_LE32(ns_header[0]) != Point_SCHEMA_HASH || NS_LE32(ns_header[1]) != 8u) return -1;
+    view->data = (const unsigned char *)buffer;
+    return 0;
+}
+
+
+int main(){
+    Reading_t r;
+    r.sensor = 7; r.channel = 513; r.seq = 0xdeadbeef; r.tag[0] = 'a'; r.tag[1] = 'b'; r.tag[2] = 'c'; r.value = -2.25;
+    unsigned char buffer[64];
+    size_t written = Reading_serialize(&r, buffer, sizeof buffer);
+    Reading_view_t view;
+    if (Reading_view(&view, buffer, written) != 0) return 1;
+    printf("%zu %u %u %x %c %g\n", written, Reading_view_sensor(view), Reading_view_channel(view), Reading_view_seq(view), Reading_view_tag(view, 2), Reading_view_value(view));
+    Point_t p;
+    p.x = -3; p.y = 9;
+    written = Point_serialize(&p, buffer, sizeof buffer);
+    Point_view_t point;
+    int status = Point_view(&point, buffer, written);
+    printf("%zu %d %d %d %d\n", written, status, Point_view_x(point), Point_view_y(point), Reading_view(&view, buffer, 64));
+    return Point_serialize(&p, buffer, 4) != 0;
+}
+
+///////////////////////////////////////
+// /tmp/reg/test_serializable.c autogenerated from test_serializable.d: 
+// #include <stdio.h>
+// 
+// struct Reading @serializable {
+//     uint8_t sensor;
+//     uint16_t channel;
+//     uint32_t seq;
+//     uint8_t tag[3];
+//     double value;
+// };
+// 
+// struct Point @serializable {
+//     int32_t x;
+//     int32_t y;
+// };
+// 
+// int main(){
+//     Reading r;
+//     r.sensor = 7; r.channel = 513; r.seq = 0xdeadbeef; r.tag[0] = 'a'; r.tag[1] = 'b'; r.tag[2] = 'c'; r.value = -2.25;
+//     unsigned char buffer[64];
+//     size_t written = Reading_serialize(&r, buffer, sizeof buffer);
+//     Reading_view_t view;
+//     if (Reading_view(&view, buffer, written) != 0) return 1;
+//     printf("%zu %u %u %x %c %g\n", written, Reading_view_sensor(view), Reading_view_channel(view), Reading_view_seq(view), Reading_view_tag(view, 2), Reading_view_value(view));
+//     Point p;
+//     p.x = -3; p.y = 9;
+//     written = Point_serialize(&p, buffer, sizeof buffer);
+//     Point_view_t point;
+//     int status = Point_view(&point, buffer, written);
+//     printf("%zu %d %d %d %d\n", written, status, Point_view_x(point), Point_view_y(point), Reading_view(&view, buffer, 64));
+//     return Point_serialize(&p, buffer, 4) != 0;
+// }
@@ -0,0 +1,71 @@
+#define NS_PRAGMA(x) _Pragma(#x)
+#if defined(_OPENMP) || defined(NS_OPENMP_SIMD)
+#define NS_DECLARE_SIMD(...) NS_PRAGMA(omp declare simd __VA_ARGS__)
+#elif defined(__GNUC__) && !defined(__clang__)
+#define NS_DECLARE_SIMD(...) __attribute__((simd("notinbranch")))
+#else
+#define NS_DECLARE_SIMD(...)
+#endif
+typedef struct Signal_s Signal_t;
+float Signal_sample(Signal_t *self, float scale, int i);
+float Signal_mix(Signal_t *self, float a, float b);
+#include <stdio.h>
+
+struct Signal_s {
+     float gain;
+};
+
+// Explicit clauses with nested parentheses
+NS_DECLARE_SIMD(uniform(self, scale) linear(i))
+float Signal_sample(Signal_t *self, float scale, int i) {
+    return self->gain * scale * (float)i;
+}
+
+// Clauses inferred from the parameters
+NS_DECLARE_SIMD(linear(self) notinbranch)
+float Signal_mix(Signal_t *self, float a, float b) {
+    return self->gain * a + b;
+}
+
+
+int main(){
+    Signal_t s;
+    s.gain = 2.0f;
+    float out[16];
+    for (int i = 0; i < 16; i++) {
+        out[i] = Signal_sample(&s, 0.5f, i) + Signal_mix(&s, 1.0f, (float)i);
+    }
+    printf("%g %g\n", out[1], out[15]);
+    return 0;
+}
+
+///////////////////////////////////////
+// test_simd.c autogenerated from test_simd.d: 
+// #include <stdio.h>
+// 
+// struct Signal{
+//     float gain;
+// 
+//     // Explicit clauses with nested parentheses
+//     @simd(uniform(self, scale), linear(i))
+//     float @sample(Signal *self, float scale, int i){
+//         return self->gain * scale * (float)i;
+//     };
+// 
+//     // Clauses inferred from the parameters
+//     @simd
+//     float @mix(Signal *self, float a, float b){
+//         return self->gain * a + b;
+//     };
+// };
+// 
+// int main(){
+//     Signal s;
+//     s.gain = 2.0f;
+//     float out[16];
+//     for (int i = 0; i < 16; i++) {
+//         out[i] = s@sample(0.5f, i) + s@mix(1.0f, (float)i);
+//     }
+//     printf("%g %g\n", out[1], out[15]);
+//     return 0;
+// }
@@ -0,0 +1,77 @@
+typedef struct Scaler_s Scaler_t;
+int Scaler_apply(Scaler_t *self, int mode, int value);
+int Scaler_apply__mode_neg1(Scaler_t *self, int value);
+int Scaler_apply__mode_1(Scaler_t *self, int value);
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Scaler_s {
+     int factor;
+};
+
+
+
+int Scaler_apply(Scaler_t *self, int mode, int value) {
+    if(mode < 0) return -value * self->factor;
+if(mode == 0) return 0;
+return value * self->factor;
+}
+
+
+int Scaler_apply__mode_neg1(Scaler_t *self, int value) {
+    const int mode = -1;
+    if(mode < 0) return -value * self->factor;
+if(mode == 0) return 0;
+return value * self->factor;
+}
+
+
+int Scaler_apply__mode_1(Scaler_t *self, int value) {
+    const int mode = 1;
+    if(mode < 0) return -value * self->factor;
+if(mode == 0) return 0;
+return value * self->factor;
+}
+
+
+int main(){
+    Scaler_t s;
+    s.factor = 3;
+    // Scaler_apply(&s, 7, 5) in a comment must not create a clone
+    if(Scaler_apply__mode_neg1(&s, 2) != -6) exit(1);
+    if(Scaler_apply__mode_neg1(&s, 4) != -12) exit(1);
+    if(Scaler_apply__mode_1(&s, 4) != 12) exit(1);
+    int mode = 0;
+    if(Scaler_apply(&s, mode, 4) != 0) exit(1);
+    printf("%d\n", Scaler_apply__mode_1(&s, 1));
+    return 0;
+}
+
+///////////////////////////////////////
+// test_specialize.c autogenerated from test_specialize.d: 
+// #include <stdio.h>
+// #include <stdlib.h>
+// 
+// struct Scaler{
+//     int factor;
+// 
+//     @specialize(mode)
+//     int @apply(Scaler *self, int mode, int value){
+//         if(mode < 0) return -value * self->factor;
+//         if(mode == 0) return 0;
+//         return value * self->factor;
+//     };
+// };
+// 
+// int main(){
+//     Scaler s;
+//     s.factor = 3;
+//     // s@apply(7, 5) in a comment must not create a clone
+//     if(s@apply(-1, 2) != -6) exit(1);
+//     if(s@apply(- 1, 4) != -12) exit(1);
+//     if(s@apply(1, 4) != 12) exit(1);
+//     int mode = 0;
+//     if(s@apply(mode, 4) != 0) exit(1);
+//     printf("%d\n", s@apply(1, 1));
+//     return 0;
+// }
@@ -0,0 +1,151 @@
+typedef struct Chars_s Chars_t;
+typedef struct Chars_globals_s Chars_globals_t;
+int Chars_count_digits(const char *text);
+#include <stdio.h>
+#include <stdint.h>
+
+struct Chars_s {
+     int unused;
+};
+
+// 1 for ASCII digits
+static const unsigned char Chars_is_digit[256] = {
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    1u, 1u, 1u, 1u, 1u, 1u, 1u, 1u,
+    1u, 1u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+    0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u,
+};
+
+static const unsigned char Chars_upper[256] = {
+    0u, 1u, 2u, 3u, 4u, 5u, 6u, 7u,
+    8u, 9u, 10u, 11u, 12u, 13u, 14u, 15u,
+    16u, 17u, 18u, 19u, 20u, 21u, 22u, 23u,
+    24u, 25u, 26u, 27u, 28u, 29u, 30u, 31u,
+    32u, 33u, 34u, 35u, 36u, 37u, 38u, 39u,
+    40u, 41u, 42u, 43u, 44u, 45u, 46u, 47u,
+    48u, 49u, 50u, 51u, 52u, 53u, 54u, 55u,
+    56u, 57u, 58u, 59u, 60u, 61u, 62u, 63u,
+    64u, 65u, 66u, 67u, 68u, 69u, 70u, 71u,
+    72u, 73u, 74u, 75u, 76u, 77u, 78u, 79u,
+    80u, 81u, 82u, 83u, 84u, 85u, 86u, 87u,
+    88u, 89u, 90u, 91u, 92u, 93u, 94u, 95u,
+    96u, 65u, 66u, 67u, 68u, 69u, 70u, 71u,
+    72u, 73u, 74u, 75u, 76u, 77u, 78u, 79u,
+    80u, 81u, 82u, 83u, 84u, 85u, 86u, 87u,
+    88u, 89u, 90u, 123u, 124u, 125u, 126u, 127u,
+    128u, 129u, 130u, 131u, 132u, 133u, 134u, 135u,
+    136u, 137u, 138u, 139u, 140u, 141u, 142u, 143u,
+    144u, 145u, 146u, 147u, 148u, 149u, 150u, 151u,
+    152u, 153u, 154u, 155u, 156u, 157u, 158u, 159u,
+    160u, 161u, 162u, 163u, 164u, 165u, 166u, 167u,
+    168u, 169u, 170u, 171u, 172u, 173u, 174u, 175u,
+    176u, 177u, 178u, 179u, 180u, 181u, 182u, 183u,
+    184u, 185u, 186u, 187u, 188u, 189u, 190u, 191u,
+    192u, 193u, 194u, 195u, 196u, 197u, 198u, 199u,
+    200u, 201u, 202u, 203u, 204u, 205u, 206u, 207u,
+    208u, 209u, 210u, 211u, 212u, 213u, 214u, 215u,
+    216u, 217u, 218u, 219u, 220u, 221u, 222u, 223u,
+    224u, 225u, 226u, 227u, 228u, 229u, 230u, 231u,
+    232u, 233u, 234u, 235u, 236u, 237u, 238u, 239u,
+    240u, 241u, 242u, 243u, 244u, 245u, 246u, 247u,
+    248u, 249u, 250u, 251u, 252u, 253u, 254u, 255u,
+};
+
+static const int Chars_squares_minus[16] = {
+    -100, -99, -96, -91, -84, -75, -64, -51,
+    -36, -19, 0, 21, 44, 69, 96, 125,
+};
+
+static const double Chars_halves[8] = {
+    0.0, 0.5, 1.0, 1.5, 2.0, 2.5, 3.0, 3.5,
+};
+
+// The untaken arm is typed but never evaluated, so its index may be out of range
+static const int Chars_clamped[8] = {
+    44, 69, 96, 125, -1, -1, -1, -1,
+};
+
+// The element type comes from a header included by the program
+static const uint32_t Chars_squares[16] = {
+    0u, 1u, 4u, 9u, 16u, 25u, 36u, 49u,
+    64u, 81u, 100u, 121u, 144u, 169u, 196u, 225u,
+};
+
+struct Chars_globals_s {
+     long calls;
+};
+Chars_globals_t Chars_globals;
+
+
+int Chars_count_digits(const char *text) {
+    int n = 0;
+(Chars_globals.calls)++;
+for(; *text; text++) n += Chars_is_digit[(unsigned char)*text];
+return n;
+}
+
+
+int main(){
+    printf("%d %c %d %g %ld\n", Chars_count_digits("a1b22c333"), Chars_upper['q'], Chars_squares_minus[5], Chars_halves[3], (Chars_globals.calls));
+    printf("%d %d %u\n", Chars_clamped[3], Chars_clamped[7], (unsigned)Chars_squares[15]);
+    return 0;
+}
+
+///////////////////////////////////////
+// test_tables.c autogenerated from test_tables.d: 
+// #include <stdio.h>
+// #include <stdint.h>
+// 
+// struct Chars{
+//     int unused;
+//     // 1 for ASCII digits
+//     @table(256) unsigned char @is_digit = i >= '0' && i <= '9';
+//     @table(256) unsigned char @upper = (i >= 'a' && i <= 'z') ? i - 32 : i;
+//     @table(16) int @squares_minus = i * i - Chars@is_digit['0' + (i % 10)] * 100;
+//     @table(8) double @halves = i / 2.0;
+//     // The untaken arm is typed but never evaluated, so its index may be out of range
+//     @table(8) int @clamped = i < 4 ? Chars@squares_minus[i + 12] : -1;
+//     // The element type comes from a header included by the program
+//     @table(16) uint32_t @squares = (uint32_t)i * (uint32_t)i;
+//     long @calls;
+//     int @count_digits(const char *text){
+//         int n = 0;
+//         Chars@calls++;
+//         for(; *text; text++) n += Chars@is_digit[(unsigned char)*text];
+//         return n;
+//     };
+// };
+// 
+// int main(){
+//     printf("%d %c %d %g %ld\n", Chars@count_digits("a1b22c333"), Chars@upper['q'], Chars@squares_minus[5], Chars@halves[3], Chars@calls);
+//     printf("%d %d %u\n", Chars@clamped[3], Chars@clamped[7], (unsigned)Chars@squares[15]);
+//     return 0;
+// }
@@ -0,0 +1,181 @@
+#if defined(__has_attribute)
+#if __has_attribute(musttail)
+#define NS_MUSTTAIL __attribute__((musttail))
+#endif
+#endif
+#ifndef NS_MUSTTAIL
+#define NS_MUSTTAIL
+#endif
+typedef struct Walker_s Walker_t;
+long Walker_sum_to(Walker_t *self, long n, long total);
+long Walker_count_down(Walker_t *self, const long n, long total);
+long Walker_halve(Walker_t *self, long n);
+long Walker_finish(Walker_t *self, const long *values, long count);
+long Walker_scratch_sum(Walker_t *self, const long *values, long count);
+long Walker_forward(Walker_t *self, const long *values, long count);
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Walker_s {
+     int steps;
+};
+
+
+
+long Walker_sum_to(Walker_t *self, long n, long total) {
+    Walker_t *ns_tail_self;
+    long ns_tail_n;
+    long ns_tail_total;
+    if (0) {
+ns_tailcall:
+        self = ns_tail_self;
+        n = ns_tail_n;
+        total = ns_tail_total;
+    }
+    if(n == 0) return total;
+self->steps++;
+{
+    ns_tail_self = self;
+    ns_tail_n = n - 1;
+    ns_tail_total = total + n;
+    goto ns_tailcall;
+}
+}
+
+// n cannot be reassigned, so the self call stays a call, with musttail where supported
+long Walker_count_down(Walker_t *self, const long n, long total) {
+    if(n == 0) return total;
+NS_MUSTTAIL return Walker_count_down(self, n - 1, total + 1);
+}
+
+// The inner n shadows the parameter; the jump must still update the parameter
+long Walker_halve(Walker_t *self, long n) {
+    Walker_t *ns_tail_self;
+    long ns_tail_n;
+    if (0) {
+ns_tailcall:
+        self = ns_tail_self;
+        n = ns_tail_n;
+    }
+    long half = n / 2;
+if(half > 0) {
+long n = half;
+self->steps++;
+{
+    ns_tail_self = self;
+    ns_tail_n = n;
+    goto ns_tailcall;
+}
+}
+return n;
+}
+
+
+
+long Walker_finish(Walker_t *self, const long *values, long count) {
+    long total = self->steps;
+for (long i = 0; i < count; i++) total += values[i];
+return total;
+}
+
+// scratch lives in this frame, so the call must not become a musttail jump
+long Walker_scratch_sum(Walker_t *self, const long *values, long count) {
+    long scratch[4];
+for (long i = 0; i < 4; i++) scratch[i] = values[0] + i;
+return Walker_finish(self, scratch, count < 4 ? count : 4);
+}
+
+
+
+long Walker_forward(Walker_t *self, const long *values, long count) {
+    NS_MUSTTAIL return Walker_finish(self, values, count);
+}
+
+
+int main(){
+    Walker_t w;
+    w.steps = 0;
+    if(Walker_sum_to(&w, 100000, 0) != 5000050000L) exit(1);
+    if(w.steps != 100000) exit(1);
+    if(Walker_count_down(&w, 1000, 0) != 1000) exit(1);
+    w.steps = 0;
+    if(Walker_halve(&w, 1000) != 1) exit(1);
+    if(w.steps != 9) exit(1);
+    w.steps = 0;
+    long values[4] = {10, 20, 30, 40};
+    if(Walker_scratch_sum(&w, values, 4) != 46) exit(1);
+    if(Walker_forward(&w, values, 4) != 100) exit(1);
+    printf("ok\n");
+    return 0;
+}
+
+///////////////////////////////////////
+// test_tailcall.c autogenerated from test_tailcall.d: 
+// #include <stdio.h>
+// #include <stdlib.h>
+// 
+// struct Walker{
+//     int steps;
+// 
+//     @tailcall
+//     long @sum_to(Walker *self, long n, long total){
+//         if(n == 0) return total;
+//         self->steps++;
+//         return self@sum_to(n - 1, total + n);
+//     };
+// 
+//     // n cannot be reassigned, so the self call stays a call, with musttail where supported
+//     @tailcall
+//     long @count_down(Walker *self, const long n, long total){
+//         if(n == 0) return total;
+//         return self@count_down(n - 1, total + 1);
+//     };
+// 
+//     // The inner n shadows the parameter; the jump must still update the parameter
+//     @tailcall
+//     long @halve(Walker *self, long n){
+//         long half = n / 2;
+//         if(half > 0) {
+//             long n = half;
+//             self->steps++;
+//             return self@halve(n);
+//         }
+//         return n;
+//     };
+// 
+//     long @finish(Walker *self, const long *values, long count){
+//         long total = self->steps;
+//         for (long i = 0; i < count; i++) total += values[i];
+//         return total;
+//     };
+// 
+//     // scratch lives in this frame, so the call must not become a musttail jump
+//     @tailcall
+//     long @scratch_sum(Walker *self, const long *values, long count){
+//         long scratch[4];
+//         for (long i = 0; i < 4; i++) scratch[i] = values[0] + i;
+//         return Walker@finish(self, scratch, count < 4 ? count : 4);
+//     };
+// 
+//     @tailcall
+//     long @forward(Walker *self, const long *values, long count){
+//         return Walker@finish(self, values, count);
+//     };
+// };
+// 
+// int main(){
+//     Walker w;
+//     w.steps = 0;
+//     if(w@sum_to(100000, 0) != 5000050000L) exit(1);
+//     if(w.steps != 100000) exit(1);
+//     if(w@count_down(1000, 0) != 1000) exit(1);
+//     w.steps = 0;
+//     if(w@halve(1000) != 1) exit(1);
+//     if(w.steps != 9) exit(1);
+//     w.steps = 0;
+//     long values[4] = {10, 20, 30, 40};
+//     if(w@scratch_sum(values, 4) != 46) exit(1);
+//     if(w@forward(values, 4) != 100) exit(1);
+//     printf("ok\n");
+//     return 0;
+// }
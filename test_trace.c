@@ -0,0 +1,234 @@
+#define NS_METHOD_COUNT 2
+static const char *const ns_method_names[NS_METHOD_COUNT] = {
+    "Tree@leaf",
+    "Tree@branch",
+};
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+// Events per thread, a power of two; events past a full ring are counted and dropped
+#ifndef NS_TRACE_RING_SIZE
+#define NS_TRACE_RING_SIZE 65536
+#endif
+typedef struct ns_trace_event {
+    uint64_t timestamp;
+    const char *method;
+    uint32_t phase;
+} ns_trace_event;
+// Single producer ring: the owning thread advances head, a flush advances tail
+typedef struct ns_trace_ring {
+    struct ns_trace_ring *next;
+    uint32_t thread_id;
+    // Owner only: open calls, and the depth of the outermost call whose events are being dropped
+    uint32_t depth;
+    uint32_t drop_depth;
+    uint64_t head;
+    uint64_t tail;
+    uint64_t dropped;
+    ns_trace_event events[NS_TRACE_RING_SIZE];
+} ns_trace_ring;
+// One registry per process: the weak definitions of every translation unit resolve to the same
+// objects, so all rings are written to a single trace by whichever unit's destructor runs first
+typedef struct ns_trace_registry {
+    ns_trace_ring *rings;
+    uint32_t threads;
+    int flushing;
+    int exited;
+} ns_trace_registry;
+__attribute__((weak)) ns_trace_registry ns_trace_shared;
+__attribute__((weak)) __thread ns_trace_ring *ns_trace_local;
+static inline uint64_t ns_trace_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+static ns_trace_ring *ns_trace_thread_ring(void) {
+    ns_trace_ring *ring = calloc(1, sizeof *ring);
+    if (!ring) return NULL;
+    ring->thread_id = __atomic_fetch_add(&ns_trace_shared.threads, 1, __ATOMIC_RELAXED) + 1;
+    ring->next = __atomic_load_n(&ns_trace_shared.rings, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&ns_trace_shared.rings, &ring->next, ring, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    ns_trace_local = ring;
+    return ring;
+}
+// A begin event is only recorded when the ring also has room for the end events of every open call,
+// so ends are never dropped; a dropped begin drops everything up to its own end to keep pairs matched
+static inline void ns_trace_emit(uint32_t method, char phase) {
+    ns_trace_ring *ring = ns_trace_local;
+    if (__builtin_expect(!ring, 0) && !(ring = ns_trace_thread_ring())) return;
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    int drop = ring->drop_depth != 0;
+    if (phase == 'B') {
+        ring->depth++;
+        if (!drop && head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) + ring->depth >= NS_TRACE_RING_SIZE) {
+            ring->drop_depth = ring->depth;
+            drop = 1;
+        }
+    } else {
+        if (ring->drop_depth == ring->depth) ring->drop_depth = 0;
+        ring->depth--;
+    }
+    if (drop) {
+        __atomic_store_n(&ring->dropped, __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+        return;
+    }
+    ns_trace_event *event = &ring->events[head & (NS_TRACE_RING_SIZE - 1)];
+    event->timestamp = ns_trace_now();
+    event->method = ns_method_names[method];
+    event->phase = (uint32_t)phase;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+// Writes and consumes every buffered event as one Chrome trace-event JSON document
+__attribute__((unused)) static void ns_trace_flush(FILE *out) {
+    while (__atomic_exchange_n(&ns_trace_shared.flushing, 1, __ATOMIC_ACQUIRE));
+    const char *separator = "";
+    uint64_t dropped = 0;
+    long pid = (long)getpid();
+    fprintf(out, "{\"traceEvents\":[");
+    for (ns_trace_ring *ring = __atomic_load_n(&ns_trace_shared.rings, __ATOMIC_ACQUIRE); ring; ring = ring->next) {
+        uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        for (uint64_t index = ring->tail; index != head; index++) {
+            const ns_trace_event *event = &ring->events[index & (NS_TRACE_RING_SIZE - 1)];
+            fprintf(out, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu.%03llu,\"pid\":%ld,\"tid\":%u}", separator,
+                    event->method, (char)event->phase,
+                    (unsigned long long)(event->timestamp / 1000), (unsigned long long)(event->timestamp % 1000),
+                    pid, ring->thread_id);
+            separator = ",";
+        }
+        __atomic_store_n(&ring->tail, head, __ATOMIC_RELEASE);
+        dropped += __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+    }
+    fprintf(out, "\n],\"otherData\":{\"dropped_events\":\"%llu\"}}\n", (unsigned long long)dropped);
+    __atomic_store_n(&ns_trace_shared.flushing, 0, __ATOMIC_RELEASE);
+}
+__attribute__((destructor)) static void ns_trace_flush_at_exit(void) {
+    if (__atomic_exchange_n(&ns_trace_shared.exited, 1, __ATOMIC_ACQ_REL)) return;
+    const char *path = getenv("NS_TRACE_OUT");
+    FILE *out = fopen(path ? path : "ns_trace.json", "w");
+    if (!out) return;
+    ns_trace_flush(out);
+    fclose(out);
+}
+typedef struct Tree_s Tree_t;
+long Tree_leaf(Tree_t *self, long value);
+long Tree_branch(Tree_t *self, long value);
+// Transpile with --instrument trace
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct Tree_s {
+     long visits;
+};
+
+
+
+static inline long Tree_leaf__body(Tree_t *self, long value) {
+    self->visits++;
+return value * 2;
+}
+long Tree_leaf(Tree_t *self, long value) {
+    ns_trace_emit(0, 'B');
+    long ns_result = Tree_leaf__body(self, value);
+    ns_trace_emit(0, 'E');
+    return ns_result;
+}
+
+
+
+static inline long Tree_branch__body(Tree_t *self, long value) {
+    return self->visits + Tree_leaf(self, value) + Tree_leaf(self, value + 1);
+}
+long Tree_branch(Tree_t *self, long value) {
+    ns_trace_emit(1, 'B');
+    long ns_result = Tree_branch__body(self, value);
+    ns_trace_emit(1, 'E');
+    return ns_result;
+}
+
+
+int main(){
+    Tree_t t;
+    t.visits = 0;
+    // 6 events per branch call overflow the 65536 event ring, so some calls are dropped
+    long total = 0;
+    for (long i = 0; i < 20000; i++) total += Tree_branch(&t, i);
+    FILE *out = tmpfile();
+    if(!out) exit(1);
+    ns_trace_flush(out);
+    long size = ftell(out);
+    char *json = malloc((size_t)size + 1);
+    if(!json) exit(1);
+    rewind(out);
+    if(fread(json, 1, (size_t)size, out) != (size_t)size) exit(1);
+    json[size] = '\0';
+    fclose(out);
+    // Every end event must close a begin event of the same thread
+    long depth = 0;
+    long begins = 0;
+    for (const char *at = json; (at = strstr(at, "\"ph\":\"")); at += 6) {
+        if(at[6] == 'B') { depth++; begins++; }
+        else if(at[6] == 'E' && --depth < 0) exit(1);
+    }
+    if(depth != 0 || begins == 0 || begins >= 60000) exit(1);
+    if(!strstr(json, "\"dropped_events\":\"") || strstr(json, "\"dropped_events\":\"0\"")) exit(1);
+    printf("%ld %ld %ld\n", total, t.visits, begins);
+    free(json);
+    // The exit flush has nothing left to write
+    setenv("NS_TRACE_OUT", "/dev/null", 1);
+    return 0;
+}
+
+///////////////////////////////////////
+// test_trace.c autogenerated from test_trace.d: 
+// // Transpile with --instrument trace
+// #include <stdio.h>
+// #include <stdlib.h>
+// #include <string.h>
+// 
+// struct Tree{
+//     long visits;
+// 
+//     long @leaf(Tree *self, long value){
+//         self->visits++;
+//         return value * 2;
+//     };
+// 
+//     long @branch(Tree *self, long value){
+//         return self->visits + Tree@leaf(self, value) + Tree@leaf(self, value + 1);
+//     };
+// };
+// 
+// int main(){
+//     Tree t;
+//     t.visits = 0;
+//     // 6 events per branch call overflow the 65536 event ring, so some calls are dropped
+//     long total = 0;
+//     for (long i = 0; i < 20000; i++) total += t@branch(i);
+//     FILE *out = tmpfile();
+//     if(!out) exit(1);
+//     ns_trace_flush(out);
+//     long size = ftell(out);
+//     char *json = malloc((size_t)size + 1);
+//     if(!json) exit(1);
+//     rewind(out);
+//     if(fread(json, 1, (size_t)size, out) != (size_t)size) exit(1);
+//     json[size] = '\0';
+//     fclose(out);
+//     // Every end event must close a begin event of the same thread
+//     long depth = 0;
+//     long begins = 0;
+//     for (const char *at = json; (at = strstr(at, "\"ph\":\"")); at += 6) {
+//         if(at[6] == 'B') { depth++; begins++; }
+//         else if(at[6] == 'E' && --depth < 0) exit(1);
+//     }
+//     if(depth != 0 || begins == 0 || begins >= 60000) exit(1);
+//     if(!strstr(json, "\"dropped_events\":\"") || strstr(json, "\"dropped_events\":\"0\"")) exit(1);
+//     printf("%ld %ld %ld\n", total, t.visits, begins);
+//     free(json);
+//     // The exit flush has nothing left to write
+//     setenv("NS_TRACE_OUT", "/dev/null", 1);
+//     return 0;
+// }
@@ -1,23 +1,26 @@
-
 typedef struct Casted_s Casted_t;
+typedef struct Casted_globals_s Casted_globals_t;
+int Casted_d();
+Casted_t Casted_aself(Casted_t *self);
+
 struct Casted_s {
      int a;
      int b;
 };
 
-typedef struct Casted_globals_s Casted_globals_t;
 struct Casted_globals_s {
      int c;
 };
 Casted_globals_t Casted_globals;
 
-
+// TODO @(dleiferives,c39474d0-2519-40cf-8d23-4f87a057ef34): explicitly add
+// void to generated member functions without any args ~#
 int Casted_d() {
     return (Casted_globals.c);
 }
 
 
-Casted_t Casted_aself(Casted_t *self, ) {
+Casted_t Casted_aself(Casted_t *self) {
     return (Casted_t)self->a;
 }
 
@@ -38,6 +41,8 @@ int main(){
 //     int a;
 //     int b;
 //     int @c;
+//     // TODO @(dleiferives,c39474d0-2519-40cf-8d23-4f87a057ef34): explicitly add
+//     // void to generated member functions without any args ~#
 //     int @d(){
 //         return Casted@c;
 //     };
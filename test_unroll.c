@@ -0,0 +1,172 @@
+#ifndef NS_PRAGMA
+#define NS_PRAGMA(x) _Pragma(#x)
+#endif
+#if defined(__clang__)
+#define NS_UNROLL(n) NS_PRAGMA(clang loop unroll_count(n))
+#elif defined(__GNUC__) && __GNUC__ >= 8
+#define NS_UNROLL(n) NS_PRAGMA(GCC unroll n)
+#else
+#define NS_UNROLL(n)
+#endif
+typedef struct Sums_s Sums_t;
+int Sums_countdown();
+int Sums_first(int n);
+int Sums_until_negative(const int *data, int n);
+int Sums_until(int limit);
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Sums_s {
+     int unused;
+};
+
+// Fully unrolled: four iterations, k is -2 afterwards as in the rolled loop
+int Sums_countdown() {
+    int total = 0;
+int k;
+{
+    k = 10;
+    {
+total += k;
+    }
+    k = 7;
+    {
+total += k;
+    }
+    k = 4;
+    {
+total += k;
+    }
+    k = 1;
+    {
+total += k;
+    }
+    k = -2;
+}
+return total * 100 + k;
+}
+
+// Partially unrolled: the trip count depends on n
+int Sums_first(int n) {
+    int total = 0;
+int i;
+{
+    i = 0;
+    for (; i < (n) && (n) - i > 3; ) {
+        {
+total += i;
+        }
+        i += 1;
+        {
+total += i;
+        }
+        i += 1;
+        {
+total += i;
+        }
+        i += 1;
+        {
+total += i;
+        }
+        i += 1;
+    }
+    for (; i < n; i++) {
+total += i;
+    }
+}
+return total * 100 + i;
+}
+
+// Left to the compiler: the body moves the bound, which unrolling only checks every four copies
+int Sums_until_negative(const int *data, int n) {
+    int total = 0;
+NS_UNROLL(4)
+for (int i = 0; i < n; i++) {
+total += data[i];
+if (data[i] < 0) n = i;
+}
+return total;
+}
+
+// Left to the compiler: the body breaks out early
+int Sums_until(int limit) {
+    int i;
+NS_UNROLL(4)
+for (i = 0; i < 100; i++) {
+if (i * i > limit) break;
+}
+return i;
+}
+
+
+int main(){
+    if(Sums_countdown() != 2200 - 2) exit(1);
+    if(Sums_first(10) != 4510) exit(1);
+    if(Sums_first(3) != 303) exit(1);
+    if(Sums_first(0) != 0) exit(1);
+    if(Sums_until(50) != 8) exit(1);
+    int data[8] = {1, 2, -1, 100, 100, 100, 100, 100};
+    if(Sums_until_negative(data, 8) != 2) exit(1);
+    printf("%d %d %d\n", Sums_countdown(), Sums_first(10), Sums_until(50));
+    return 0;
+}
+
+///////////////////////////////////////
+// test_unroll.c autogenerated from test_unroll.d: 
+// #include <stdio.h>
+// #include <stdlib.h>
+// 
+// struct Sums{
+//     int unused;
+// 
+//     // Fully unrolled: four iterations, k is -2 afterwards as in the rolled loop
+//     int @countdown(){
+//         int total = 0;
+//         int k;
+//         @unroll(2) for (k = 10; k > 0; k -= 3) {
+//             total += k;
+//         }
+//         return total * 100 + k;
+//     };
+// 
+//     // Partially unrolled: the trip count depends on n
+//     int @first(int n){
+//         int total = 0;
+//         int i;
+//         @unroll(4) for (i = 0; i < n; i++) {
+//             total += i;
+//         }
+//         return total * 100 + i;
+//     };
+// 
+//     // Left to the compiler: the body moves the bound, which unrolling only checks every four copies
+//     int @until_negative(const int *data, int n){
+//         int total = 0;
+//         @unroll(4) for (int i = 0; i < n; i++) {
+//             total += data[i];
+//             if (data[i] < 0) n = i;
+//         }
+//         return total;
+//     };
+// 
+//     // Left to the compiler: the body breaks out early
+//     int @until(int limit){
+//         int i;
+//         @unroll(4) for (i = 0; i < 100; i++) {
+//             if (i * i > limit) break;
+//         }
+//         return i;
+//     };
+// };
+// 
+// int main(){
+//     if(Sums@countdown() != 2200 - 2) exit(1);
+//     if(Sums@first(10) != 4510) exit(1);
+//     if(Sums@first(3) != 303) exit(1);
+//     if(Sums@first(0) != 0) exit(1);
+//     if(Sums@until(50) != 8) exit(1);
+//     int data[8] = {1, 2, -1, 100, 100, 100, 100, 100};
+//     if(Sums@until_negative(data, 8) != 2) exit(1);
+//     printf("%d %d %d\n", Sums@countdown(), Sums@first(10), Sums@until(50));
+//     return 0;
+// }
@@ -0,0 +1,211 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define NS_HOST_BIG_ENDIAN 1
+#else
+#define NS_HOST_BIG_ENDIAN 0
+#endif
+#if defined(__GNUC__)
+#define NS_PACKED __attribute__((packed))
+#define NS_BSWAP16(x) __builtin_bswap16(x)
+#define NS_BSWAP32(x) __builtin_bswap32(x)
+#define NS_BSWAP64(x) __builtin_bswap64(x)
+#else
+#define NS_PACKED
+#define NS_BSWAP16(x) ((uint16_t)((uint16_t)(x) >> 8 | (uint16_t)(x) << 8))
+#define NS_BSWAP32(x) ((uint32_t)NS_BSWAP16((uint16_t)(x)) << 16 | NS_BSWAP16((uint16_t)((x) >> 16)))
+#define NS_BSWAP64(x) ((uint64_t)NS_BSWAP32((uint32_t)(x)) << 32 | NS_BSWAP32((uint32_t)((x) >> 32)))
+#endif
+static inline float ns_bswap_float(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof bits);
+    bits = NS_BSWAP32(bits);
+    memcpy(&value, &bits, sizeof bits);
+    return value;
+}
+static inline double ns_bswap_double(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof bits);
+    bits = NS_BSWAP64(bits);
+    memcpy(&value, &bits, sizeof bits);
+    return value;
+}
+typedef struct Header_s Header_t;
+typedef struct Header_wire_s Header_wire_t;
+void Header_decode(Header_t *out, const Header_wire_t *in, size_t count);
+void Header_encode(Header_wire_t *out, const Header_t *in, size_t count);
+int Header_size(Header_t *self);
+typedef struct Sample_s Sample_t;
+typedef struct Sample_wire_s Sample_wire_t;
+void Sample_decode(Sample_t *out, const Sample_wire_t *in, size_t count);
+void Sample_encode(Sample_wire_t *out, const Sample_t *in, size_t count);
+#include <stdio.h>
+#include <stdint.h>
+
+struct Header_s {
+     uint8_t version;
+     uint8_t flags;
+     uint16_t length;
+     uint32_t seq;
+     uint8_t mac[6];
+     int16_t delta;
+     double scale;
+};
+
+struct Header_wire_s {
+    uint8_t version;
+    uint8_t flags;
+    uint16_t length;
+    uint32_t seq;
+    uint8_t mac[6];
+    int16_t delta;
+    double scale;
+} NS_PACKED;
+void Header_decode(Header_t *out, const Header_wire_t *in, size_t count) {
+#if NS_HOST_BIG_ENDIAN
+    _Static_assert(sizeof(Header_t) == sizeof(Header_wire_t), "Header has padding");
+    memcpy(out, in, count * sizeof *out);
+#else
+    for (size_t ns_n = 0; ns_n < count; ns_n++) {
+        out[ns_n].version = in[ns_n].version;
+        out[ns_n].flags = in[ns_n].flags;
+        out[ns_n].length = (uint16_t)NS_BSWAP16((uint16_t)in[ns_n].length);
+        out[ns_n].seq = (uint32_t)NS_BSWAP32((uint32_t)in[ns_n].seq);
+        for (size_t ns_k = 0; ns_k < 6; ns_k++) out[ns_n].mac[ns_k] = in[ns_n].mac[ns_k];
+        out[ns_n].delta = (int16_t)NS_BSWAP16((uint16_t)in[ns_n].delta);
+        out[ns_n].scale = ns_bswap_double(in[ns_n].scale);
+    }
+#endif
+}
+void Header_encode(Header_wire_t *out, const Header_t *in, size_t count) {
+#if NS_HOST_BIG_ENDIAN
+    _Static_assert(sizeof(Header_t) == sizeof(Header_wire_t), "Header has padding");
+    memcpy(out, in, count * sizeof *out);
+#else
+    for (size_t ns_n = 0; ns_n < count; ns_n++) {
+        out[ns_n].version = in[ns_n].version;
+        out[ns_n].flags = in[ns_n].flags;
+        out[ns_n].length = (uint16_t)NS_BSWAP16((uint16_t)in[ns_n].length);
+        out[ns_n].seq = (uint32_t)NS_BSWAP32((uint32_t)in[ns_n].seq);
+        for (size_t ns_k = 0; ns_k < 6; ns_k++) out[ns_n].mac[ns_k] = in[ns_n].mac[ns_k];
+        out[ns_n].delta = (int16_t)NS_BSWAP16((uint16_t)in[ns_n].delta);
+        out[ns_n].scale = ns_bswap_double(in[ns_n].scale);
+    }
+#endif
+}
+
+
+int Header_size(Header_t *self) {
+    return self->length;
+}
+
+
+struct Sample_s {
+     uint32_t id;
+     uint16_t channel;
+     float value;
+};
+
+struct Sample_wire_s {
+    uint32_t id;
+    uint16_t channel;
+    float value;
+} NS_PACKED;
+void Sample_decode(Sample_t *out, const Sample_wire_t *in, size_t count) {
+#if !NS_HOST_BIG_ENDIAN
+    for (size_t ns_n = 0; ns_n < count; ns_n++) {
+        out[ns_n].id = in[ns_n].id;
+        out[ns_n].channel = in[ns_n].channel;
+        out[ns_n].value = in[ns_n].value;
+    }
+#else
+    for (size_t ns_n = 0; ns_n < count; ns_n++) {
+        out[ns_n].id = (uint32_t)NS_BSWAP32((uint32_t)in[ns_n].id);
+        out[ns_n].channel = (uint16_t)NS_BSWAP16((uint16_t)in[ns_n].channel);
+        out[ns_n].value = ns_bswap_float(in[ns_n].value);
+    }
+#endif
+}
+void Sample_encode(Sample_wire_t *out, const Sample_t *in, size_t count) {
+#if !NS_HOST_BIG_ENDIAN
+    for (size_t ns_n = 0; ns_n < count; ns_n++) {
+        out[ns_n].id = in[ns_n].id;
+        out[ns_n].channel = in[ns_n].channel;
+        out[ns_n].value = in[ns_n].value;
+    }
+#else
+    for (size_t ns_n = 0; ns_n < count; ns_n++) {
+        out[ns_n].id = (uint32_t)NS_BSWAP32((uint32_t)in[ns_n].id);
+        out[ns_n].channel = (uint16_t)NS_BSWAP16((uint16_t)in[ns_n].channel);
+        out[ns_n].value = ns_bswap_float(in[ns_n].value);
+    }
+#endif
+}
+
+
+int main(){
+    unsigned char bytes[] = {1, 2, 0x01, 0x02, 0xde, 0xad, 0xbe, 0xef, 1, 2, 3, 4, 5, 6, 0xff, 0xfe, 0x3f, 0xf8, 0, 0, 0, 0, 0, 0};
+    Header_wire_t wire;
+    memcpy(&wire, bytes, sizeof wire);
+    Header_t h;
+    Header_decode(&h, &wire, 1);
+    printf("%zu %u %u %d %x %d %d %g\n", sizeof wire, h.version, h.flags, Header_size(&h), h.seq, h.mac[5], h.delta, h.scale);
+    Header_wire_t back;
+    Header_encode(&back, &h, 1);
+    printf("%d\n", memcmp(&back, bytes, sizeof back));
+    Sample_t s[2];
+    s[0].id = 1; s[0].channel = 2; s[0].value = 1.5f;
+    s[1].id = 3; s[1].channel = 4; s[1].value = 2.5f;
+    Sample_wire_t sw[2];
+    Sample_encode(sw, s, 2);
+    Sample_t d[2];
+    Sample_decode(d, sw, 2);
+    printf("%u %u %g %u\n", d[1].id, d[1].channel, d[1].value, ((unsigned char *)sw)[0]);
+    return 0;
+}
+
+///////////////////////////////////////
+// test_wire.c autogenerated from test_wire.d: 
+// #include <stdio.h>
+// #include <stdint.h>
+// 
+// struct Header @wire(big) {
+//     uint8_t version;
+//     uint8_t flags;
+//     uint16_t length;
+//     uint32_t seq;
+//     uint8_t mac[6];
+//     int16_t delta;
+//     double scale;
+//     int @size(Header *self){
+//         return self->length;
+//     };
+// };
+// 
+// struct Sample @wire(little) {
+//     uint32_t id;
+//     uint16_t channel;
+//     float value;
+// };
+// 
+// int main(){
+//     unsigned char bytes[] = {1, 2, 0x01, 0x02, 0xde, 0xad, 0xbe, 0xef, 1, 2, 3, 4, 5, 6, 0xff, 0xfe, 0x3f, 0xf8, 0, 0, 0, 0, 0, 0};
+//     Header_wire_t wire;
+//     memcpy(&wire, bytes, sizeof wire);
+//     Header h;
+//     Header_decode(&h, &wire, 1);
+//     printf("%zu %u %u %d %x %d %d %g\n", sizeof wire, h.version, h.flags, h@size(), h.seq, h.mac[5], h.delta, h.scale);
+//     Header_wire_t back;
+//     Header_encode(&back, &h, 1);
+//     printf("%d\n", memcmp(&back, bytes, sizeof back));
+//     Sample s[2];
+//     s[0].id = 1; s[0].channel = 2; s[0].value = 1.5f;
+//     s[1].id = 3; s[1].channel = 4; s[1].value = 2.5f;
+//     Sample_wire_t sw[2];
+//     Sample_encode(sw, s, 2);
+//     Sample d[2];
+//     Sample_decode(d, sw, 2);
+//     printf("%u %u %g %u\n", d[1].id, d[1].channel, d[1].value, ((unsigned char *)sw)[0]);
+//     return 0;
+// }